@@ -43,6 +43,7 @@
 #include <stdlib.h>
 #include <vector>
 #include <sstream>
+#include <omp.h>
 #include "MaxPooling.h"
 #include "Sigmoid.h"
 #include "BitShifter.h"
@@ -55,35 +56,29 @@
 #include "formula.h"
 #include "Param.h"
 #include "Chip.h"
+#include "TraceFile.h"
+#include "TracePrefetch.h"
+#include "WeightCache.h"
+#include "SimulationContext.h"
 
 using namespace std;
 
 extern Param *param;
-double globalBusWidth = 0;
-int numBufferCore = 0;				  
 
-/*** Circuit Modules ***/
-Buffer *globalBuffer;
-HTree *GhTree;
-AdderTree *Gaccumulation;
-Sigmoid *Gsigmoid;
-BitShifter *GreLu;
-MaxPooling *maxPool;
 
-
-vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, bool pip, const vector<vector<double> > &netStructure,
+vector<int> ChipDesignInitialize(SimulationContext& ctx, InputParameter& inputParameter, Technology& tech, MemCell& cell, bool pip, const vector<vector<double> > &netStructure,
 					double *maxPESizeNM, double *maxTileSizeCM, double *numPENM){
 
-	globalBuffer = new Buffer(inputParameter, tech, cell);
-	GhTree = new HTree(inputParameter, tech, cell);
-	Gaccumulation = new AdderTree(inputParameter, tech, cell);
-	Gsigmoid = new Sigmoid(inputParameter, tech, cell);
-	GreLu = new BitShifter(inputParameter, tech, cell);
-	maxPool = new MaxPooling(inputParameter, tech, cell);
+	ctx.globalBuffer = new Buffer(inputParameter, tech, cell);
+	ctx.GhTree = new HTree(inputParameter, tech, cell);
+	ctx.Gaccumulation = new AdderTree(inputParameter, tech, cell);
+	ctx.Gsigmoid = new Sigmoid(inputParameter, tech, cell);
+	ctx.GreLu = new BitShifter(inputParameter, tech, cell);
+	ctx.maxPool = new MaxPooling(inputParameter, tech, cell);
 
 	int numRowPerSynapse, numColPerSynapse;
-	numRowPerSynapse = param->numRowPerSynapse;
-	numColPerSynapse = param->numColPerSynapse;
+	numRowPerSynapse = ctx.config.numRowPerSynapse;
+	numColPerSynapse = ctx.config.numColPerSynapse;
 	
 	double numLayer, minCube;
 	
@@ -95,7 +90,7 @@ vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tec
 	*numPENM = 0;
 
 	vector<int> markNM;
-	if (param->novelMapping) {
+	if (ctx.config.novelMapping) {
 		// define number of PE in COV layers
 		int most = 0;
 		int numPE = 0;
@@ -118,7 +113,7 @@ vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tec
 			
 			if ((netStructure[i][3]*netStructure[i][4]== (*numPENM))
 				// large Cov layers use novel mapping
-				&&(netStructure[i][2]*netStructure[i][3]*netStructure[i][4]*numRowPerSynapse >= param->numRowSubArray)) {
+				&&(netStructure[i][2]*netStructure[i][3]*netStructure[i][4]*numRowPerSynapse >= ctx.config.numRowSubArray)) {
 				markNM.push_back(1);
 				minCube = pow(2, ceil((double) log2((double) netStructure[i][5]*(double) numColPerSynapse) ) );
 				*maxPESizeNM = max(minCube, (*maxPESizeNM));
@@ -140,7 +135,7 @@ vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tec
 	
 	// for pipeline system
 	vector<int> pipelineSpeedUp;
-	if (param->pipeline) {
+	if (ctx.config.pipeline) {
 		// find max and min IFM size --> define how much the system can be speed-up
 		int maxIFMSize = netStructure[0][0];
 		int minIFMSize = maxIFMSize;
@@ -155,13 +150,13 @@ vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tec
 		
 		// justify the speed-up degree is necessary
 		int maxSpeedUpDegree = int(maxIFMSize/minIFMSize);
-		if (maxSpeedUpDegree < param->speedUpDegree) {
+		if (maxSpeedUpDegree < ctx.config.speedUpDegree) {
 			cout << "User assigned speed-up degree is larger than the upper bound (where no idle period during the whole process) " << endl;
-			param->speedUpDegree = maxSpeedUpDegree;
+			ctx.config.speedUpDegree = maxSpeedUpDegree;
 			cout << "The speed-up degree is auto-assigned as the upper bound (where no idle period during the whole process) " << endl;
 		}
 		// define the pipeline speed-up
-		int boundIFMSize = ceil((double) maxIFMSize/(param->speedUpDegree));
+		int boundIFMSize = ceil((double) maxIFMSize/(ctx.config.speedUpDegree));
 		for (int i=0; i<numLayer; i++) {
 			int speedUp = ceil((double) pow((netStructure[i][0]/boundIFMSize), 2));
 			pipelineSpeedUp.push_back(speedUp);
@@ -355,11 +350,11 @@ vector<vector<double> > ChipFloorPlan(bool findNumTile, bool findUtilization, bo
 }
 
 
-void ChipInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, const vector<vector<double> > &netStructure, const vector<int > &markNM, const vector<vector<double> > &numTileEachLayer,
+void ChipInitialize(SimulationContext& ctx, InputParameter& inputParameter, Technology& tech, MemCell& cell, const vector<vector<double> > &netStructure, const vector<int > &markNM, const vector<vector<double> > &numTileEachLayer,
 					double numPENM, double desiredNumTileNM, double desiredPESizeNM, double desiredNumTileCM, double desiredTileSizeCM, double desiredPESizeCM, int numTileRow, int numTileCol) { 
 
 	/*** Initialize Tile ***/
-	TileInitialize(inputParameter, tech, cell, numPENM, desiredPESizeNM, ceil((double)(desiredTileSizeCM)/(double)(desiredPESizeCM)), desiredPESizeCM);
+	TileInitialize(ctx, inputParameter, tech, cell, numPENM, desiredPESizeNM, ceil((double)(desiredTileSizeCM)/(double)(desiredPESizeCM)), desiredPESizeCM);
 	
 	// find max layer and define the global buffer: enough to hold the max layer inputs
 	double maxLayerInput = 0;
@@ -367,21 +362,21 @@ void ChipInitialize(InputParameter& inputParameter, Technology& tech, MemCell& c
 	double maxTileAdded = 0;
 	for (int i=0; i<netStructure.size(); i++) {
 		double input = netStructure[i][0]*netStructure[i][1]*netStructure[i][2];  // IFM_Row * IFM_Column * IFM_depth
-		if (! param->pipeline) {
+		if (! ctx.config.pipeline) {
 			if (input > maxLayerInput) {
 				maxLayerInput = input;
 			}
 			if (markNM[i] == 0) {
-				globalBusWidth += (desiredTileSizeCM)+(desiredTileSizeCM)/param->numColMuxed;
+				ctx.globalBusWidth += (desiredTileSizeCM)+(desiredTileSizeCM)/ctx.config.numColMuxed;
 			} else {
-				globalBusWidth += (desiredPESizeNM)*ceil((double)sqrt(numPENM))+(desiredPESizeNM)*ceil((double)sqrt(numPENM))/param->numColMuxed;
+				ctx.globalBusWidth += (desiredPESizeNM)*ceil((double)sqrt(numPENM))+(desiredPESizeNM)*ceil((double)sqrt(numPENM))/ctx.config.numColMuxed;
 			}
 		} else {
 			maxLayerInput += netStructure[i][0]*netStructure[i][1]*netStructure[i][2]/2;
 			if (markNM[i] == 0) {
-				globalBusWidth += ((desiredTileSizeCM)+(desiredTileSizeCM)/param->numColMuxed)*numTileEachLayer[0][i]*numTileEachLayer[1][i];
+				ctx.globalBusWidth += ((desiredTileSizeCM)+(desiredTileSizeCM)/ctx.config.numColMuxed)*numTileEachLayer[0][i]*numTileEachLayer[1][i];
 			} else {
-				globalBusWidth += ((desiredPESizeNM)*ceil((double)sqrt(numPENM))+(desiredPESizeNM)*ceil((double)sqrt(numPENM))/param->numColMuxed)*numTileEachLayer[0][i]*numTileEachLayer[1][i];
+				ctx.globalBusWidth += ((desiredPESizeNM)*ceil((double)sqrt(numPENM))+(desiredPESizeNM)*ceil((double)sqrt(numPENM))/ctx.config.numColMuxed)*numTileEachLayer[0][i]*numTileEachLayer[1][i];
 			}
 		}
 		
@@ -391,83 +386,83 @@ void ChipInitialize(InputParameter& inputParameter, Technology& tech, MemCell& c
 		}
 	}
 	// have to limit the global bus width --> cannot grow dramatically with num of tile
-	while (globalBusWidth > param->maxGlobalBusWidth) {
-		globalBusWidth /= 2;
+	while (ctx.globalBusWidth > ctx.config.maxGlobalBusWidth) {
+		ctx.globalBusWidth /= 2;
 	}
 	
 	// define bufferSize for inference operation
-	int bufferSize = param->numBitInput*maxLayerInput;										 
+	int bufferSize = ctx.config.numBitInput*maxLayerInput;										 
 	
-	//globalBuffer->Initialize(param->numBitInput*maxLayerInput, globalBusWidth, 1, param->unitLengthWireResistance, param->clkFreq, param->globalBufferType);
-	numBufferCore = ceil(bufferSize/(param->globalBufferCoreSizeRow*param->globalBufferCoreSizeCol));
-	//numBufferCore = ceil(1.5*numBufferCore);
-	globalBuffer->Initialize((param->globalBufferCoreSizeRow*param->globalBufferCoreSizeCol), param->globalBufferCoreSizeCol, 1, param->unitLengthWireResistance, param->clkFreq, param->globalBufferType);
+	//ctx.globalBuffer->Initialize(ctx.config.numBitInput*maxLayerInput, ctx.globalBusWidth, 1, ctx.config.unitLengthWireResistance, ctx.config.clkFreq, ctx.config.globalBufferType);
+	ctx.numBufferCore = ceil(bufferSize/(ctx.config.globalBufferCoreSizeRow*ctx.config.globalBufferCoreSizeCol));
+	//ctx.numBufferCore = ceil(1.5*ctx.numBufferCore);
+	ctx.globalBuffer->Initialize((ctx.config.globalBufferCoreSizeRow*ctx.config.globalBufferCoreSizeCol), ctx.config.globalBufferCoreSizeCol, 1, ctx.config.unitLengthWireResistance, ctx.config.clkFreq, ctx.config.globalBufferType);
 	
-	maxPool->Initialize(param->numBitInput, 2*2, (desiredTileSizeCM));
-	GhTree->Initialize((numTileRow), (numTileCol), param->globalBusDelayTolerance, globalBusWidth);
+	ctx.maxPool->Initialize(ctx.config.numBitInput, 2*2, (desiredTileSizeCM));
+	ctx.GhTree->Initialize((numTileRow), (numTileCol), ctx.config.globalBusDelayTolerance, ctx.globalBusWidth);
 	
 	
 	//activation inside Tile or outside?
-	if (param->chipActivation) {
+	if (ctx.config.chipActivation) {
 		int maxThroughputTile, maxAddFromSubArray;
-		if (param->novelMapping) {
+		if (ctx.config.novelMapping) {
 			maxThroughputTile = (int) max((desiredTileSizeCM), ceil((double)sqrt(numPENM))*(desiredPESizeNM));
-			maxAddFromSubArray = (int) max(ceil((double)(desiredPESizeCM)/(double)param->numRowSubArray), ceil((double)(desiredPESizeNM)/(double)param->numRowSubArray));   // from subArray to ProcessingUnit
+			maxAddFromSubArray = (int) max(ceil((double)(desiredPESizeCM)/(double)ctx.config.numRowSubArray), ceil((double)(desiredPESizeNM)/(double)ctx.config.numRowSubArray));   // from subArray to ProcessingUnit
 			maxAddFromSubArray *= (int) max(ceil((double)(desiredTileSizeCM)/(double)(desiredPESizeCM)), ceil((double)sqrt(numPENM)));    // from ProcessingUnit to Tile
-			if (param->pipeline) {
+			if (ctx.config.pipeline) {
 				maxThroughputTile *= (netStructure.size()+1);
 				maxAddFromSubArray *= (netStructure.size()+1);
 			}
-			if (param->parallelRead) {
-				Gaccumulation->Initialize((int) maxTileAdded, ceil((double) log2((double) param->levelOutput))+param->numBitInput+1+ceil((double) log2((double) maxAddFromSubArray)), 
-										ceil((double) maxThroughputTile/(double) param->numColMuxed));
+			if (ctx.config.parallelRead) {
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ceil((double) log2((double) ctx.config.levelOutput))+ctx.config.numBitInput+1+ceil((double) log2((double) maxAddFromSubArray)), 
+										ceil((double) maxThroughputTile/(double) ctx.config.numColMuxed));
 			} else {
-				Gaccumulation->Initialize((int) maxTileAdded, ceil((double) log2((double) param->numRowSubArray)+(double) param->cellBit-1)+param->numBitInput+1+ceil((double) log2((double) maxAddFromSubArray)), 
-										ceil((double) maxThroughputTile/(double) param->numColMuxed));
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ceil((double) log2((double) ctx.config.numRowSubArray)+(double) ctx.config.cellBit-1)+ctx.config.numBitInput+1+ceil((double) log2((double) maxAddFromSubArray)), 
+										ceil((double) maxThroughputTile/(double) ctx.config.numColMuxed));
 			}
-			if (param->reLu) {
-				GreLu->Initialize(ceil((double) maxThroughputTile/(double) param->numColMuxed), param->numBitInput, param->clkFreq);
+			if (ctx.config.reLu) {
+				ctx.GreLu->Initialize(ceil((double) maxThroughputTile/(double) ctx.config.numColMuxed), ctx.config.numBitInput, ctx.config.clkFreq);
 			} else {
-				Gsigmoid->Initialize(false, param->numBitInput, ceil((double) log2((double) param->numRowSubArray)+(double) param->cellBit-1)+param->numBitInput+1+log2((double) maxAddFromSubArray)+ceil((double) log2((double) maxTileAdded)), 
-										ceil((double) maxThroughputTile/(double) param->numColMuxed), param->clkFreq);
+				ctx.Gsigmoid->Initialize(false, ctx.config.numBitInput, ceil((double) log2((double) ctx.config.numRowSubArray)+(double) ctx.config.cellBit-1)+ctx.config.numBitInput+1+log2((double) maxAddFromSubArray)+ceil((double) log2((double) maxTileAdded)), 
+										ceil((double) maxThroughputTile/(double) ctx.config.numColMuxed), ctx.config.clkFreq);
 			}
 		} else {
-			maxAddFromSubArray = (int) ceil((double)(desiredPESizeCM)/(double)param->numRowSubArray);   // from subArray to ProcessingUnit
+			maxAddFromSubArray = (int) ceil((double)(desiredPESizeCM)/(double)ctx.config.numRowSubArray);   // from subArray to ProcessingUnit
 			maxAddFromSubArray *= (int) ceil((double)(desiredTileSizeCM)/(double)(desiredPESizeCM));    // from ProcessingUnit to Tile
-			if (param->pipeline) {
+			if (ctx.config.pipeline) {
 				maxAddFromSubArray *= (netStructure.size()+1);
 			}
-			if (param->parallelRead) {
-				Gaccumulation->Initialize((int) maxTileAdded, ceil((double)log2((double)param->levelOutput))+param->numBitInput+1+ceil((double)log2((double)maxAddFromSubArray)), 
-										ceil((double)(desiredTileSizeCM)/(double)param->numColMuxed));
+			if (ctx.config.parallelRead) {
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ceil((double)log2((double)ctx.config.levelOutput))+ctx.config.numBitInput+1+ceil((double)log2((double)maxAddFromSubArray)), 
+										ceil((double)(desiredTileSizeCM)/(double)ctx.config.numColMuxed));
 			} else {
-				Gaccumulation->Initialize((int) maxTileAdded, ceil((double)log2((double)param->numRowSubArray)+(double)param->cellBit-1)+param->numBitInput+1+ceil((double)log2((double)maxAddFromSubArray)), 
-										ceil((double)(desiredTileSizeCM)/(double)param->numColMuxed));
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ceil((double)log2((double)ctx.config.numRowSubArray)+(double)ctx.config.cellBit-1)+ctx.config.numBitInput+1+ceil((double)log2((double)maxAddFromSubArray)), 
+										ceil((double)(desiredTileSizeCM)/(double)ctx.config.numColMuxed));
 			}
-			if (param->reLu) {
-				GreLu->Initialize(ceil((double)(desiredTileSizeCM)/(double)param->numColMuxed), param->numBitInput, param->clkFreq);
+			if (ctx.config.reLu) {
+				ctx.GreLu->Initialize(ceil((double)(desiredTileSizeCM)/(double)ctx.config.numColMuxed), ctx.config.numBitInput, ctx.config.clkFreq);
 			} else {
-				Gsigmoid->Initialize(false, param->numBitInput, ceil((double) log2((double) param->numRowSubArray)+(double) param->cellBit-1)+param->numBitInput+1+log2((double) maxAddFromSubArray)+ceil((double) log2((double) maxTileAdded)), 
-										ceil((double) (desiredTileSizeCM)/(double) param->numColMuxed), param->clkFreq);
+				ctx.Gsigmoid->Initialize(false, ctx.config.numBitInput, ceil((double) log2((double) ctx.config.numRowSubArray)+(double) ctx.config.cellBit-1)+ctx.config.numBitInput+1+log2((double) maxAddFromSubArray)+ceil((double) log2((double) maxTileAdded)), 
+										ceil((double) (desiredTileSizeCM)/(double) ctx.config.numColMuxed), ctx.config.clkFreq);
 			}
 		}
 	} else {   // activation inside tiles
 		int maxThroughputTile;
-		if (param->novelMapping) {
+		if (ctx.config.novelMapping) {
 			maxThroughputTile = (int) max((desiredTileSizeCM), ceil((double) sqrt((double) numPENM))*(double) (desiredPESizeNM));
-			if (param->pipeline) {
+			if (ctx.config.pipeline) {
 				maxThroughputTile *= (netStructure.size()+1);
 			}
-			if (param->parallelRead) {
-				Gaccumulation->Initialize((int) maxTileAdded, param->numBitInput, ceil((double) maxThroughputTile/(double) param->numColMuxed));
+			if (ctx.config.parallelRead) {
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ctx.config.numBitInput, ceil((double) maxThroughputTile/(double) ctx.config.numColMuxed));
 			} else {
-				Gaccumulation->Initialize((int) maxTileAdded, param->numBitInput, ceil((double) maxThroughputTile/(double) param->numColMuxed));
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ctx.config.numBitInput, ceil((double) maxThroughputTile/(double) ctx.config.numColMuxed));
 			}
 		} else {
-			if (param->parallelRead) {
-				Gaccumulation->Initialize((int) maxTileAdded, param->numBitInput, ceil((double) (desiredTileSizeCM)/(double) param->numColMuxed));
+			if (ctx.config.parallelRead) {
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ctx.config.numBitInput, ceil((double) (desiredTileSizeCM)/(double) ctx.config.numColMuxed));
 			} else {
-				Gaccumulation->Initialize((int) maxTileAdded, param->numBitInput, ceil((double) (desiredTileSizeCM)/(double) param->numColMuxed));
+				ctx.Gaccumulation->Initialize((int) maxTileAdded, ctx.config.numBitInput, ceil((double) (desiredTileSizeCM)/(double) ctx.config.numColMuxed));
 			}
 		}
 	}
@@ -475,7 +470,7 @@ void ChipInitialize(InputParameter& inputParameter, Technology& tech, MemCell& c
 
 
 
-vector<double> ChipCalculateArea(InputParameter& inputParameter, Technology& tech, MemCell& cell, double desiredNumTileNM, double numPENM, double desiredPESizeNM, double desiredNumTileCM, double desiredTileSizeCM, 
+vector<double> ChipCalculateArea(SimulationContext& ctx, InputParameter& inputParameter, Technology& tech, MemCell& cell, double desiredNumTileNM, double numPENM, double desiredPESizeNM, double desiredNumTileCM, double desiredTileSizeCM, 
 						double desiredPESizeCM, int numTileRow, double *height, double *width, double *CMTileheight, double *CMTilewidth, double *NMTileheight, double *NMTilewidth) {
 	
 	vector<double> areaResults;
@@ -502,8 +497,8 @@ vector<double> ChipCalculateArea(InputParameter& inputParameter, Technology& tec
 	vector<double> areaCMTile;
 	vector<double> areaNMTile;
 	
-	if (param->novelMapping) {
-		areaNMTile = TileCalculateArea(numPENM, desiredPESizeNM, true, &NMheight, &NMwidth);
+	if (ctx.config.novelMapping) {
+		areaNMTile = TileCalculateArea(ctx, numPENM, desiredPESizeNM, true, &NMheight, &NMwidth);
 		double NMTileArea = areaNMTile[0];
 		double NMTileAreaIC = areaNMTile[1];
 		double NMTileAreaADC = areaNMTile[2];
@@ -519,7 +514,7 @@ vector<double> ChipCalculateArea(InputParameter& inputParameter, Technology& tec
 		*NMTileheight = NMheight;
 		*NMTilewidth = NMwidth;
 	}
-	areaCMTile = TileCalculateArea(pow(ceil((double) desiredTileSizeCM/(double) desiredPESizeCM), 2), desiredPESizeCM, false, &CMheight, &CMwidth);
+	areaCMTile = TileCalculateArea(ctx, pow(ceil((double) desiredTileSizeCM/(double) desiredPESizeCM), 2), desiredPESizeCM, false, &CMheight, &CMwidth);
 	
 	double CMTileArea = areaCMTile[0];
 	double CMTileAreaIC = areaCMTile[1];
@@ -537,38 +532,38 @@ vector<double> ChipCalculateArea(InputParameter& inputParameter, Technology& tec
 	*CMTilewidth = CMwidth;
 	
 	// global buffer is made up by multiple cores
-	globalBuffer->CalculateArea(numTileRow*max(NMheight, CMheight), NULL, NONE);
-	double globalBufferArea = globalBuffer->area*numBufferCore;
+	ctx.globalBuffer->CalculateArea(numTileRow*max(NMheight, CMheight), NULL, NONE);
+	double globalBufferArea = ctx.globalBuffer->area*ctx.numBufferCore;
 	double globalBufferHeight = numTileRow*max(NMheight, CMheight);
 	double globalBufferWidth = globalBufferArea/globalBufferHeight;														
-	GhTree->CalculateArea(max(NMheight, CMheight), max(NMwidth, CMwidth), param->treeFoldedRatio);
-	maxPool->CalculateUnitArea(NONE);
-	maxPool->CalculateArea(globalBufferWidth);
-	Gaccumulation->CalculateArea(NULL, globalBufferHeight/3, NONE);
+	ctx.GhTree->CalculateArea(max(NMheight, CMheight), max(NMwidth, CMwidth), ctx.config.treeFoldedRatio);
+	ctx.maxPool->CalculateUnitArea(NONE);
+	ctx.maxPool->CalculateArea(globalBufferWidth);
+	ctx.Gaccumulation->CalculateArea(NULL, globalBufferHeight/3, NONE);
 	
 	double areaGreLu = 0;
 	double areaGsigmoid = 0;
 	
-	if (param->chipActivation) {
-		if (param->reLu) {
-			GreLu->CalculateArea(NULL, globalBufferWidth/3, NONE);
-			area += GreLu->area;
-			areaGreLu += GreLu->area;
+	if (ctx.config.chipActivation) {
+		if (ctx.config.reLu) {
+			ctx.GreLu->CalculateArea(NULL, globalBufferWidth/3, NONE);
+			area += ctx.GreLu->area;
+			areaGreLu += ctx.GreLu->area;
 		} else {
-			Gsigmoid->CalculateUnitArea(NONE);
-			Gsigmoid->CalculateArea(NULL, globalBufferWidth/3, NONE);
-			area += Gsigmoid->area;
-			areaGsigmoid += Gsigmoid->area;
+			ctx.Gsigmoid->CalculateUnitArea(NONE);
+			ctx.Gsigmoid->CalculateArea(NULL, globalBufferWidth/3, NONE);
+			area += ctx.Gsigmoid->area;
+			areaGsigmoid += ctx.Gsigmoid->area;
 		}
 	}
 	
-	area += globalBufferArea + GhTree->area + maxPool->area + Gaccumulation->area;
-	areaIC += GhTree->area;
+	area += globalBufferArea + ctx.GhTree->area + ctx.maxPool->area + ctx.Gaccumulation->area;
+	areaIC += ctx.GhTree->area;
 	areaResults.push_back(area);
 	areaResults.push_back(areaIC);
 	areaResults.push_back(areaADC);
-	areaResults.push_back(areaAccum + Gaccumulation->area);
-	areaResults.push_back(areaOther + globalBufferArea + maxPool->area + areaGreLu + areaGsigmoid);
+	areaResults.push_back(areaAccum + ctx.Gaccumulation->area);
+	areaResults.push_back(areaOther + globalBufferArea + ctx.maxPool->area + areaGreLu + areaGsigmoid);
 	areaResults.push_back(areaArray);
 	
 	*height = sqrt(area);
@@ -578,17 +573,33 @@ vector<double> ChipCalculateArea(InputParameter& inputParameter, Technology& tec
 }
 
 
-double ChipCalculatePerformance(InputParameter& inputParameter, Technology& tech, MemCell& cell, int layerNumber, const string &newweightfile, const string &oldweightfile, const string &inputfile, bool followedByMaxPool, 
+static void ChipLayerPerformance(SimulationContext& ctx, InputParameter& inputParameter, Technology& tech, MemCell& cell, int layerNumber, const LevelMatrix &newMemory, const Matrix &inputVector, int numInVector, bool followedByMaxPool, 
 							const vector<vector<double> > &netStructure, const vector<int> &markNM, const vector<vector<double> > &numTileEachLayer, const vector<vector<double> > &utilizationEachLayer, 
 							const vector<vector<double> > &speedUpEachLayer, const vector<vector<double> > &tileLocaEachLayer, double numPENM, double desiredPESizeNM, double desiredTileSizeCM, 
 							double desiredPESizeCM, double CMTileheight, double CMTilewidth, double NMTileheight, double NMTilewidth,
 							double *readLatency, double *readDynamicEnergy, double *leakage, double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy, 
 							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther) {
 	
+	// in a team of threads, a first pass spawns the subArrays of all tiles and PEs of the layer as tasks instead of waiting for those of each PE
+	// before the next one, the taskgroup waits for all of them and this pass then takes their results in the original order (see SubArrayDeferMode)
+	bool deferred = (ctx.subArrayDeferMode == deferOff && ctx.subArrayStreamMode != streamReplay && omp_get_num_threads() > 1);
+	if (deferred) {
+		ctx.subArrayDeferMode = deferSpawn;
+		ctx.subArrayDeferredJob.clear();
+		#pragma omp taskgroup
+		{
+			ChipLayerPerformance(ctx, inputParameter, tech, cell, layerNumber, newMemory, inputVector, numInVector, followedByMaxPool, netStructure, markNM, numTileEachLayer, utilizationEachLayer, 
+							speedUpEachLayer, tileLocaEachLayer, numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth, 
+							readLatency, readDynamicEnergy, leakage, bufferLatency, bufferDynamicEnergy, icLatency, icDynamicEnergy, 
+							coreLatencyADC, coreLatencyAccum, coreLatencyOther, coreEnergyADC, coreEnergyAccum, coreEnergyOther);
+		}
+		ctx.subArrayDeferMode = deferCollect;
+		ctx.subArrayDeferredCall = 0;
+	}
 	
 	int numRowPerSynapse, numColPerSynapse;
-	numRowPerSynapse = param->numRowPerSynapse;
-	numColPerSynapse = param->numColPerSynapse;
+	numRowPerSynapse = ctx.config.numRowPerSynapse;
+	numColPerSynapse = ctx.config.numColPerSynapse;
 	
 	// only get performance of single layer
 	int l = layerNumber;
@@ -596,12 +607,6 @@ double ChipCalculatePerformance(InputParameter& inputParameter, Technology& tech
 	int weightMatrixRow = netStructure[l][2]*netStructure[l][3]*netStructure[l][4]*numRowPerSynapse;
 	int weightMatrixCol = netStructure[l][5]*numColPerSynapse;
 	
-	// load in whole file 
-	vector<vector<double> > inputVector;
-	inputVector = LoadInInputData(inputfile); 
-	vector<vector<double> > newMemory;
-	newMemory = LoadInWeightData(newweightfile, numRowPerSynapse, numColPerSynapse, param->maxConductance, param->minConductance);
-	
 	*readLatency = 0;
 	*readDynamicEnergy = 0;
 	*leakage = 0;
@@ -619,7 +624,13 @@ double ChipCalculatePerformance(InputParameter& inputParameter, Technology& tech
 	
 	double tileLeakage = 0;
 	
-	int numInVector = (netStructure[l][0]-netStructure[l][3]+1)/netStructure[l][7]*(netStructure[l][1]-netStructure[l][4]+1)/netStructure[l][7];
+	// the accumulation units of the tiles and PEs only update their leakage when the layer goes through them, start from none rather than
+	// from the leakage left by the layer simulated before on this chip, so that the results do not depend on the layer order (param->concurrentLayers)
+	ctx.accumulationCM->leakage = 0;
+	ctx.accumulationNM->leakage = 0;
+	ctx.adderTreeCM->leakage = 0;
+	ctx.adderTreeNM->leakage = 0;
+	
 	int totalNumTile = 0;
 	for (int i=0; i<netStructure.size(); i++) {
 		totalNumTile += numTileEachLayer[0][i] * numTileEachLayer[1][i];
@@ -646,14 +657,14 @@ double ChipCalculatePerformance(InputParameter& inputParameter, Technology& tech
 				int numColMatrix = min(desiredTileSizeCM, weightMatrixCol-j*desiredTileSizeCM);
 				
 				// assign weight and input to specific tile
-				vector<vector<double> > tileMemory;
-				tileMemory = CopyArray(newMemory, i*desiredTileSizeCM, j*desiredTileSizeCM, numRowMatrix, numColMatrix);
+				LevelMatrixView tileMemory;
+				tileMemory = LevelMatrixView(newMemory).Sub(i*desiredTileSizeCM, j*desiredTileSizeCM, numRowMatrix, numColMatrix);
 				
-				vector<vector<double> > tileInput;
-				tileInput = CopyInput(inputVector, i*desiredTileSizeCM, numInVector*param->numBitInput, numRowMatrix);
+				MatrixView tileInput;
+				tileInput = MatrixView(inputVector).Sub(i*desiredTileSizeCM, 0, numRowMatrix, numInVector*ctx.config.numBitInput);
 				
-				TileCalculatePerformance(tileMemory, tileMemory, tileInput, markNM[l], ceil((double)desiredTileSizeCM/(double)desiredPESizeCM), desiredPESizeCM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
-									numRowMatrix, numColMatrix, numInVector*param->numBitInput, cell, &tileReadLatency, &tileReadDynamicEnergy, &tileLeakage,
+				TileCalculatePerformance(ctx, tileMemory, tileMemory, tileInput, markNM[l], ceil((double)desiredTileSizeCM/(double)desiredPESizeCM), desiredPESizeCM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
+									numRowMatrix, numColMatrix, numInVector*ctx.config.numBitInput, cell, &tileReadLatency, &tileReadDynamicEnergy, &tileLeakage,
 									&tilebufferLatency, &tilebufferDynamicEnergy, &tileicLatency, &tileicDynamicEnergy, 
 									&tileLatencyADC, &tileLatencyAccum, &tileLatencyOther, &tileEnergyADC, &tileEnergyAccum, &tileEnergyOther);
 
@@ -673,60 +684,60 @@ double ChipCalculatePerformance(InputParameter& inputParameter, Technology& tech
 				*coreEnergyOther += tileEnergyOther;
 			}
 		}
-		if (param->chipActivation) {
-			if (param->reLu) {
-				GreLu->CalculateLatency(ceil(numInVector*netStructure[l][5]/(double) GreLu->numUnit));
-				GreLu->CalculatePower(ceil(numInVector*netStructure[l][5]/(double) GreLu->numUnit));
-				*readLatency += GreLu->readLatency;
-				*readDynamicEnergy += GreLu->readDynamicEnergy;
-				*coreLatencyOther += GreLu->readLatency;
-				*coreEnergyOther += GreLu->readDynamicEnergy;
+		if (ctx.config.chipActivation) {
+			if (ctx.config.reLu) {
+				ctx.GreLu->CalculateLatency(ceil(numInVector*netStructure[l][5]/(double) ctx.GreLu->numUnit));
+				ctx.GreLu->CalculatePower(ceil(numInVector*netStructure[l][5]/(double) ctx.GreLu->numUnit));
+				*readLatency += ctx.GreLu->readLatency;
+				*readDynamicEnergy += ctx.GreLu->readDynamicEnergy;
+				*coreLatencyOther += ctx.GreLu->readLatency;
+				*coreEnergyOther += ctx.GreLu->readDynamicEnergy;
 			} else {
-				Gsigmoid->CalculateLatency(ceil(numInVector*netStructure[l][5]/Gsigmoid->numEntry));
-				Gsigmoid->CalculatePower(ceil(numInVector*netStructure[l][5]/Gsigmoid->numEntry));
-				*readLatency += Gsigmoid->readLatency;
-				*readDynamicEnergy += Gsigmoid->readDynamicEnergy;
-				*coreLatencyOther += Gsigmoid->readLatency;
-				*coreEnergyOther += Gsigmoid->readDynamicEnergy;
+				ctx.Gsigmoid->CalculateLatency(ceil(numInVector*netStructure[l][5]/ctx.Gsigmoid->numEntry));
+				ctx.Gsigmoid->CalculatePower(ceil(numInVector*netStructure[l][5]/ctx.Gsigmoid->numEntry));
+				*readLatency += ctx.Gsigmoid->readLatency;
+				*readDynamicEnergy += ctx.Gsigmoid->readDynamicEnergy;
+				*coreLatencyOther += ctx.Gsigmoid->readLatency;
+				*coreEnergyOther += ctx.Gsigmoid->readDynamicEnergy;
 			}
 		}
 		
 		if (numTileEachLayer[0][l] > 1) {   
-			Gaccumulation->CalculateLatency(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) Gaccumulation->numAdderTree)), numTileEachLayer[0][l], 0);
-			Gaccumulation->CalculatePower(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) Gaccumulation->numAdderTree)), numTileEachLayer[0][l]);
-			*readLatency += Gaccumulation->readLatency;
-			*readDynamicEnergy += Gaccumulation->readDynamicEnergy;
-			*coreLatencyAccum += Gaccumulation->readLatency;
-			*coreEnergyAccum += Gaccumulation->readDynamicEnergy;
+			ctx.Gaccumulation->CalculateLatency(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) ctx.Gaccumulation->numAdderTree)), numTileEachLayer[0][l], 0);
+			ctx.Gaccumulation->CalculatePower(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) ctx.Gaccumulation->numAdderTree)), numTileEachLayer[0][l]);
+			*readLatency += ctx.Gaccumulation->readLatency;
+			*readDynamicEnergy += ctx.Gaccumulation->readDynamicEnergy;
+			*coreLatencyAccum += ctx.Gaccumulation->readLatency;
+			*coreEnergyAccum += ctx.Gaccumulation->readDynamicEnergy;
 		}
 		
 		// if this layer is followed by Max Pool
 		if (followedByMaxPool) {
-			maxPool->CalculateLatency(1e20, 0, ceil((double) (numInVector/(double) maxPool->window)/(double) desiredTileSizeCM));
-			maxPool->CalculatePower(ceil((double) (numInVector/maxPool->window)/(double) desiredTileSizeCM));
-			*readLatency += maxPool->readLatency;
-			*readDynamicEnergy += maxPool->readDynamicEnergy;
-			*coreLatencyOther += maxPool->readLatency;
-			*coreEnergyOther += maxPool->readDynamicEnergy;
+			ctx.maxPool->CalculateLatency(1e20, 0, ceil((double) (numInVector/(double) ctx.maxPool->window)/(double) desiredTileSizeCM));
+			ctx.maxPool->CalculatePower(ceil((double) (numInVector/ctx.maxPool->window)/(double) desiredTileSizeCM));
+			*readLatency += ctx.maxPool->readLatency;
+			*readDynamicEnergy += ctx.maxPool->readDynamicEnergy;
+			*coreLatencyOther += ctx.maxPool->readLatency;
+			*coreEnergyOther += ctx.maxPool->readDynamicEnergy;
 		}							  
 		
-		double numBitToLoadOut = weightMatrixRow*param->numBitInput*numInVector;
-		double numBitToLoadIn = ceil(weightMatrixCol/param->numColPerSynapse)*param->numBitInput*numInVector/(netStructure[l][6]? 4:1);
+		double numBitToLoadOut = weightMatrixRow*ctx.config.numBitInput*numInVector;
+		double numBitToLoadIn = ceil(weightMatrixCol/ctx.config.numColPerSynapse)*ctx.config.numBitInput*numInVector/(netStructure[l][6]? 4:1);
 		
-		GhTree->CalculateLatency(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], CMTileheight, CMTilewidth, ceil((numBitToLoadOut+numBitToLoadIn)/ceil(GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
-		GhTree->CalculatePower(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], CMTileheight, CMTilewidth, ceil(GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile)), 
-							ceil((numBitToLoadOut+numBitToLoadIn)/ceil(GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
-		globalBuffer->CalculateLatency(globalBuffer->interface_width, numBitToLoadOut/globalBuffer->interface_width,
-								globalBuffer->interface_width, numBitToLoadIn/globalBuffer->interface_width);
-		globalBuffer->CalculatePower(globalBuffer->interface_width, numBitToLoadOut/globalBuffer->interface_width,
-								globalBuffer->interface_width, numBitToLoadIn/globalBuffer->interface_width);
+		ctx.GhTree->CalculateLatency(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], CMTileheight, CMTilewidth, ceil((numBitToLoadOut+numBitToLoadIn)/ceil(ctx.GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
+		ctx.GhTree->CalculatePower(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], CMTileheight, CMTilewidth, ceil(ctx.GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile)), 
+							ceil((numBitToLoadOut+numBitToLoadIn)/ceil(ctx.GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
+		ctx.globalBuffer->CalculateLatency(ctx.globalBuffer->interface_width, numBitToLoadOut/ctx.globalBuffer->interface_width,
+								ctx.globalBuffer->interface_width, numBitToLoadIn/ctx.globalBuffer->interface_width);
+		ctx.globalBuffer->CalculatePower(ctx.globalBuffer->interface_width, numBitToLoadOut/ctx.globalBuffer->interface_width,
+								ctx.globalBuffer->interface_width, numBitToLoadIn/ctx.globalBuffer->interface_width);
 		
 		// since multi-core buffer has improve the parallelism
-		globalBuffer->readLatency /= MIN(numBufferCore, ceil(globalBusWidth/globalBuffer->interface_width));
-		globalBuffer->writeLatency /= MIN(numBufferCore, ceil(globalBusWidth/globalBuffer->interface_width));
+		ctx.globalBuffer->readLatency /= MIN(ctx.numBufferCore, ceil(ctx.globalBusWidth/ctx.globalBuffer->interface_width));
+		ctx.globalBuffer->writeLatency /= MIN(ctx.numBufferCore, ceil(ctx.globalBusWidth/ctx.globalBuffer->interface_width));
 		// each time, only a part of the ic is used to transfer data to a part of the tiles
-		globalBuffer->readLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));
-		globalBuffer->writeLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));
+		ctx.globalBuffer->readLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));
+		ctx.globalBuffer->writeLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));
 		
 	} else {   // novel Mapping
 		for (int i=0; i<ceil((double) netStructure[l][2]*(double) numRowPerSynapse/(double) desiredPESizeNM); i++) {       // # of tiles in row
@@ -752,17 +763,17 @@ double ChipCalculatePerformance(InputParameter& inputParameter, Technology& tech
 				int numColMatrix = min(desiredPESizeNM, weightMatrixCol-j*desiredPESizeNM);
 				
 				// assign weight and input to specific tile
-				vector<vector<double> > tileMemory;
-				tileMemory = ReshapeArray(newMemory, i*desiredPESizeNM, j*desiredPESizeNM, (int) netStructure[l][2]*numRowPerSynapse/numtileEachLayerRow, 
+				LevelMatrixView tileMemory;
+				tileMemory = LevelMatrixView(newMemory).Reshape(i*desiredPESizeNM, j*desiredPESizeNM, (int) netStructure[l][2]*numRowPerSynapse/numtileEachLayerRow, 
 									(int) netStructure[l][5]*numColPerSynapse/numtileEachLayerCol, numPENM, (int) netStructure[l][2]*numRowPerSynapse);
 
-				vector<vector<double> > tileInput;
-				tileInput = ReshapeInput(inputVector, i*desiredPESizeNM, (int) (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, 
-									(int) netStructure[l][2]*numRowPerSynapse/numtileEachLayerRow, numPENM, (int) netStructure[l][2]*numRowPerSynapse);
+				MatrixView tileInput;
+				tileInput = MatrixView(inputVector).Reshape(i*desiredPESizeNM, 0, (int) netStructure[l][2]*numRowPerSynapse/numtileEachLayerRow, 
+									numInVector*ctx.config.numBitInput, numPENM, (int) netStructure[l][2]*numRowPerSynapse);
 	
 				
-				TileCalculatePerformance(tileMemory, tileMemory, tileInput, markNM[l], numPENM, desiredPESizeNM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
-									numRowMatrix, numColMatrix, numInVector*param->numBitInput, cell, 
+				TileCalculatePerformance(ctx, tileMemory, tileMemory, tileInput, markNM[l], numPENM, desiredPESizeNM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
+									numRowMatrix, numColMatrix, numInVector*ctx.config.numBitInput, cell, 
 									&tileReadLatency, &tileReadDynamicEnergy, &tileLeakage, &tilebufferLatency, &tilebufferDynamicEnergy, &tileicLatency, &tileicDynamicEnergy,
 									&tileLatencyADC, &tileLatencyAccum, &tileLatencyOther, &tileEnergyADC, &tileEnergyAccum, &tileEnergyOther);
 				
@@ -784,72 +795,141 @@ double ChipCalculatePerformance(InputParameter& inputParameter, Technology& tech
 			}
 		}
 		
-		if (param->chipActivation) {
-			if (param->reLu) {
-				GreLu->CalculateLatency(ceil(numInVector*netStructure[l][5]/(double) GreLu->numUnit));
-				GreLu->CalculatePower(ceil(numInVector*netStructure[l][5]/(double) GreLu->numUnit));
-				*readLatency += GreLu->readLatency;
-				*readDynamicEnergy += GreLu->readDynamicEnergy;
-				*coreLatencyOther += GreLu->readLatency;
-				*coreEnergyOther += GreLu->readDynamicEnergy;
+		if (ctx.config.chipActivation) {
+			if (ctx.config.reLu) {
+				ctx.GreLu->CalculateLatency(ceil(numInVector*netStructure[l][5]/(double) ctx.GreLu->numUnit));
+				ctx.GreLu->CalculatePower(ceil(numInVector*netStructure[l][5]/(double) ctx.GreLu->numUnit));
+				*readLatency += ctx.GreLu->readLatency;
+				*readDynamicEnergy += ctx.GreLu->readDynamicEnergy;
+				*coreLatencyOther += ctx.GreLu->readLatency;
+				*coreEnergyOther += ctx.GreLu->readDynamicEnergy;
 			} else {
-				Gsigmoid->CalculateLatency(ceil(numInVector*netStructure[l][5]/Gsigmoid->numEntry));
-				Gsigmoid->CalculatePower(ceil(numInVector*netStructure[l][5]/Gsigmoid->numEntry));
-				*readLatency += Gsigmoid->readLatency;
-				*readDynamicEnergy += Gsigmoid->readDynamicEnergy;
-				*coreLatencyOther += Gsigmoid->readLatency;
-				*coreEnergyOther += Gsigmoid->readDynamicEnergy;
+				ctx.Gsigmoid->CalculateLatency(ceil(numInVector*netStructure[l][5]/ctx.Gsigmoid->numEntry));
+				ctx.Gsigmoid->CalculatePower(ceil(numInVector*netStructure[l][5]/ctx.Gsigmoid->numEntry));
+				*readLatency += ctx.Gsigmoid->readLatency;
+				*readDynamicEnergy += ctx.Gsigmoid->readDynamicEnergy;
+				*coreLatencyOther += ctx.Gsigmoid->readLatency;
+				*coreEnergyOther += ctx.Gsigmoid->readDynamicEnergy;
 			}
 		}
 		
 		if (numTileEachLayer[0][l] > 1) {   
-			Gaccumulation->CalculateLatency(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) Gaccumulation->numAdderTree)), numTileEachLayer[0][l], 0);
-			Gaccumulation->CalculatePower(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) Gaccumulation->numAdderTree)), numTileEachLayer[0][l]);
-			*readLatency += Gaccumulation->readLatency;
-			*readDynamicEnergy += Gaccumulation->readDynamicEnergy;
-			*coreLatencyAccum += Gaccumulation->readLatency;
-			*coreEnergyAccum += Gaccumulation->readDynamicEnergy;
+			ctx.Gaccumulation->CalculateLatency(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) ctx.Gaccumulation->numAdderTree)), numTileEachLayer[0][l], 0);
+			ctx.Gaccumulation->CalculatePower(ceil(numTileEachLayer[1][l]*netStructure[l][5]*(numInVector/(double) ctx.Gaccumulation->numAdderTree)), numTileEachLayer[0][l]);
+			*readLatency += ctx.Gaccumulation->readLatency;
+			*readDynamicEnergy += ctx.Gaccumulation->readDynamicEnergy;
+			*coreLatencyAccum += ctx.Gaccumulation->readLatency;
+			*coreEnergyAccum += ctx.Gaccumulation->readDynamicEnergy;
 		}
 		
 		// if this layer is followed by Max Pool
 		if (followedByMaxPool) {
-			maxPool->CalculateLatency(1e20, 0, ceil((double) (numInVector/(double) maxPool->window)/(double) desiredPESizeNM*sqrt((double) numPENM)));
-			maxPool->CalculatePower(ceil((double) (numInVector/maxPool->window)/(double) desiredPESizeNM*sqrt((double) numPENM)));
-			*readLatency += maxPool->readLatency;
-			*readDynamicEnergy += maxPool->readDynamicEnergy;
-			*coreLatencyOther += maxPool->readLatency;
-			*coreEnergyOther += maxPool->readDynamicEnergy;
+			ctx.maxPool->CalculateLatency(1e20, 0, ceil((double) (numInVector/(double) ctx.maxPool->window)/(double) desiredPESizeNM*sqrt((double) numPENM)));
+			ctx.maxPool->CalculatePower(ceil((double) (numInVector/ctx.maxPool->window)/(double) desiredPESizeNM*sqrt((double) numPENM)));
+			*readLatency += ctx.maxPool->readLatency;
+			*readDynamicEnergy += ctx.maxPool->readDynamicEnergy;
+			*coreLatencyOther += ctx.maxPool->readLatency;
+			*coreEnergyOther += ctx.maxPool->readDynamicEnergy;
 		}
-		double numBitToLoadOut = weightMatrixRow*param->numBitInput*numInVector/netStructure[l][3];
-		double numBitToLoadIn = ceil(weightMatrixCol/param->numColPerSynapse)*param->numBitInput*numInVector/(netStructure[l][6]? 4:1);
+		double numBitToLoadOut = weightMatrixRow*ctx.config.numBitInput*numInVector/netStructure[l][3];
+		double numBitToLoadIn = ceil(weightMatrixCol/ctx.config.numColPerSynapse)*ctx.config.numBitInput*numInVector/(netStructure[l][6]? 4:1);
 		
-		GhTree->CalculateLatency(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], NMTileheight, NMTilewidth, ceil((numBitToLoadOut+numBitToLoadIn)/ceil(GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
-		GhTree->CalculatePower(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], NMTileheight, NMTilewidth, ceil(GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile)), 
-							ceil((numBitToLoadOut+numBitToLoadIn)/ceil(GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
+		ctx.GhTree->CalculateLatency(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], NMTileheight, NMTilewidth, ceil((numBitToLoadOut+numBitToLoadIn)/ceil(ctx.GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
+		ctx.GhTree->CalculatePower(0, 0, tileLocaEachLayer[0][l], tileLocaEachLayer[1][l], NMTileheight, NMTilewidth, ceil(ctx.GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile)), 
+							ceil((numBitToLoadOut+numBitToLoadIn)/ceil(ctx.GhTree->busWidth*(numTileEachLayer[0][l]*numTileEachLayer[1][l]/totalNumTile))));
 		
-		globalBuffer->CalculateLatency(globalBuffer->interface_width, numBitToLoadOut/globalBuffer->interface_width,
-								globalBuffer->interface_width, numBitToLoadIn/globalBuffer->interface_width);
-		globalBuffer->CalculatePower(globalBuffer->interface_width, numBitToLoadOut/globalBuffer->interface_width,
-								globalBuffer->interface_width, numBitToLoadIn/globalBuffer->interface_width);
+		ctx.globalBuffer->CalculateLatency(ctx.globalBuffer->interface_width, numBitToLoadOut/ctx.globalBuffer->interface_width,
+								ctx.globalBuffer->interface_width, numBitToLoadIn/ctx.globalBuffer->interface_width);
+		ctx.globalBuffer->CalculatePower(ctx.globalBuffer->interface_width, numBitToLoadOut/ctx.globalBuffer->interface_width,
+								ctx.globalBuffer->interface_width, numBitToLoadIn/ctx.globalBuffer->interface_width);
 		// since multi-core buffer has improve the parallelism
-		globalBuffer->readLatency /= MIN(numBufferCore, ceil(globalBusWidth/globalBuffer->interface_width));
-		globalBuffer->writeLatency /= MIN(numBufferCore, ceil(globalBusWidth/globalBuffer->interface_width));
+		ctx.globalBuffer->readLatency /= MIN(ctx.numBufferCore, ceil(ctx.globalBusWidth/ctx.globalBuffer->interface_width));
+		ctx.globalBuffer->writeLatency /= MIN(ctx.numBufferCore, ceil(ctx.globalBusWidth/ctx.globalBuffer->interface_width));
 		// each time, only a part of the ic is used to transfer data to a part of the tiles
-		globalBuffer->readLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));
-		globalBuffer->writeLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));	
+		ctx.globalBuffer->readLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));
+		ctx.globalBuffer->writeLatency *= ceil(totalNumTile/(numTileEachLayer[0][l]*numTileEachLayer[1][l]));	
 	}		
-	*bufferLatency += globalBuffer->readLatency + globalBuffer->writeLatency;
-	*bufferDynamicEnergy += globalBuffer->readDynamicEnergy + globalBuffer->writeDynamicEnergy;
-	*icLatency += GhTree->readLatency;
-	*icDynamicEnergy += GhTree->readDynamicEnergy;
-	
-	*readLatency += globalBuffer->readLatency + globalBuffer->writeLatency + GhTree->readLatency;
-	*readDynamicEnergy += globalBuffer->readDynamicEnergy + globalBuffer->writeDynamicEnergy + GhTree->readDynamicEnergy;
-	*coreLatencyOther += globalBuffer->readLatency + globalBuffer->writeLatency + GhTree->readLatency;
-	*coreEnergyOther += globalBuffer->readDynamicEnergy + globalBuffer->writeDynamicEnergy + GhTree->readDynamicEnergy;
+	*bufferLatency += ctx.globalBuffer->readLatency + ctx.globalBuffer->writeLatency;
+	*bufferDynamicEnergy += ctx.globalBuffer->readDynamicEnergy + ctx.globalBuffer->writeDynamicEnergy;
+	*icLatency += ctx.GhTree->readLatency;
+	*icDynamicEnergy += ctx.GhTree->readDynamicEnergy;
+	
+	*readLatency += ctx.globalBuffer->readLatency + ctx.globalBuffer->writeLatency + ctx.GhTree->readLatency;
+	*readDynamicEnergy += ctx.globalBuffer->readDynamicEnergy + ctx.globalBuffer->writeDynamicEnergy + ctx.GhTree->readDynamicEnergy;
+	*coreLatencyOther += ctx.globalBuffer->readLatency + ctx.globalBuffer->writeLatency + ctx.GhTree->readLatency;
+	*coreEnergyOther += ctx.globalBuffer->readDynamicEnergy + ctx.globalBuffer->writeDynamicEnergy + ctx.GhTree->readDynamicEnergy;
 
 	*leakage = tileLeakage;
 	
+	if (deferred) {
+		if (ctx.subArrayDeferredCall != ctx.subArrayDeferredJob.size()) {
+			cout << "ERROR!: the second pass of a layer takes fewer subArrays than its first pass spawned" << endl;
+			exit(-1);
+		}
+		ctx.subArrayDeferredJob.clear();
+		ctx.subArrayDeferMode = deferOff;
+	}
+}
+
+
+void ChipCalculatePerformance(SimulationContext& ctx, InputParameter& inputParameter, Technology& tech, MemCell& cell, int layerNumber, const string &newweightfile, const string &oldweightfile, const string &inputfile, bool followedByMaxPool, 
+							const vector<vector<double> > &netStructure, const vector<int> &markNM, const vector<vector<double> > &numTileEachLayer, const vector<vector<double> > &utilizationEachLayer, 
+							const vector<vector<double> > &speedUpEachLayer, const vector<vector<double> > &tileLocaEachLayer, double numPENM, double desiredPESizeNM, double desiredTileSizeCM, 
+							double desiredPESizeCM, double CMTileheight, double CMTilewidth, double NMTileheight, double NMTilewidth,
+							double *readLatency, double *readDynamicEnergy, double *leakage, double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy, 
+							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther) {
+	
+	int l = layerNumber;
+	int numInVector = (netStructure[l][0]-netStructure[l][3]+1)/netStructure[l][7]*(netStructure[l][1]-netStructure[l][4]+1)/netStructure[l][7];
+	bool streamed = StreamedLayer(netStructure, l);
+	
+	// load in whole file, or take the traces loaded by the prefetch thread while the previous layer was simulated
+	LayerTraces loaded;
+	const LayerTraces *traces = &loaded;
+	if (ctx.tracePrefetch) {
+		traces = &ctx.tracePrefetch->Get(l, newweightfile, inputfile);
+	} else {
+		LoadLayerTraces(newweightfile, inputfile, streamed, &loaded);
+	}
+	const LevelMatrix &newMemory = *traces->weight;
+	if (!streamed) {
+		ChipLayerPerformance(ctx, inputParameter, tech, cell, layerNumber, newMemory, *traces->input, numInVector, followedByMaxPool, netStructure, markNM, numTileEachLayer, utilizationEachLayer, 
+							speedUpEachLayer, tileLocaEachLayer, numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth, 
+							readLatency, readDynamicEnergy, leakage, bufferLatency, bufferDynamicEnergy, icLatency, icDynamicEnergy, 
+							coreLatencyADC, coreLatencyAccum, coreLatencyOther, coreEnergyADC, coreEnergyAccum, coreEnergyOther);
+		FreeLayerTraces(&loaded);
+		return;
+	}
+	
+	// streaming: the layer is first simulated chunk by chunk of input vectors, only the summed subArray results of these passes are kept,
+	// then the final pass over all input vectors replays them (the subArray latencies are combined by MAX, so the chunks cannot be added up at the chip level)
+	const TraceFile &infile = *traces->inputFile;
+	double chunk[13];
+	ctx.subArrayStreamCost.clear();
+	ctx.subArrayStreamMode = streamAccumulate;
+	for (int start=0; start<numInVector; start+=ctx.config.inputChunkSize) {
+		int numChunkVector = min(ctx.config.inputChunkSize, numInVector-start);
+		Matrix inputChunk = LoadInInputData(infile, start*ctx.config.numBitInput, numChunkVector*ctx.config.numBitInput);
+		ctx.subArrayStreamCall = 0;
+		ChipLayerPerformance(ctx, inputParameter, tech, cell, layerNumber, newMemory, inputChunk, numChunkVector, followedByMaxPool, netStructure, markNM, numTileEachLayer, utilizationEachLayer, 
+							speedUpEachLayer, tileLocaEachLayer, numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth, 
+							&chunk[0], &chunk[1], &chunk[2], &chunk[3], &chunk[4], &chunk[5], &chunk[6], 
+							&chunk[7], &chunk[8], &chunk[9], &chunk[10], &chunk[11], &chunk[12]);
+	}
+	Matrix noInput;
+	ctx.subArrayStreamMode = streamReplay;
+	ctx.subArrayStreamCall = 0;
+	ChipLayerPerformance(ctx, inputParameter, tech, cell, layerNumber, newMemory, noInput, numInVector, followedByMaxPool, netStructure, markNM, numTileEachLayer, utilizationEachLayer, 
+							speedUpEachLayer, tileLocaEachLayer, numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth, 
+							readLatency, readDynamicEnergy, leakage, bufferLatency, bufferDynamicEnergy, icLatency, icDynamicEnergy, 
+							coreLatencyADC, coreLatencyAccum, coreLatencyOther, coreEnergyADC, coreEnergyAccum, coreEnergyOther);
+	if (ctx.subArrayStreamCall != ctx.subArrayStreamCost.size()) {
+		cout << "ERROR!: the final pass of a streamed layer evaluates fewer subArrays than its chunks" << endl;
+		exit(-1);
+	}
+	ctx.subArrayStreamMode = streamOff;
+	ctx.subArrayStreamCost.clear();
+	FreeLayerTraces(&loaded);
 }
 
 
@@ -1084,34 +1164,34 @@ vector<vector<double> > OverallEachLayer(bool utilization, bool speedUp, const v
 
 
 
-vector<vector<double> > LoadInWeightData(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance) {
-	
-	ifstream fileone(weightfile.c_str());                           
-	string lineone;
-	string valone;
+LevelMatrix LoadInWeightData(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance) {
 	
-	int ROW = 0;
-	int COL = 0;
-	
-	if (!fileone.good()) {                                       
-		cerr << "Error: the fileone cannot be opened!" << endl;
-		exit(1);
-	}else{
-		while (getline(fileone, lineone, '\n')) {                   
-			ROW++;                                             
+	// a cached mapping of the same trace and settings skips the parsing and mapping below
+	WeightCacheKey cacheKey;
+	bool cached = !param->weightCacheDir.empty() && GetWeightCacheKey(weightfile, numRowPerSynapse, numColPerSynapse, maxConductance, minConductance, &cacheKey);
+	if (cached) {
+		LevelMatrix weight;
+		if (ReadWeightCache(cacheKey, &weight)) {
+			return weight;
 		}
-		fileone.clear();
-		fileone.seekg(0, ios::beg);                               
-		if (getline(fileone, lineone, '\n')) {                      
-			istringstream iss (lineone);                         
-			while (getline(iss, valone, ',')) {                   
-				COL++;
-			}
-		}	
 	}
-	fileone.clear();
-	fileone.seekg(0, ios::beg);                   
 	
+	TraceFile fileone(weightfile);
+	if (!fileone.good) {                                       
+		TraceLoadFailed("Error: the fileone cannot be opened!", 1);
+	}
+	if (fileone.binary && (fileone.header.kind != traceWeight || fileone.header.bits != (uint32_t) param->synapseBit)) {
+		ostringstream error;
+		error << "ERROR!: " << weightfile << " is not a " << param->synapseBit << "-bit weight trace!";
+		TraceLoadFailed(error.str(), -1);
+	}
+	if (fileone.binary && fileone.header.mode != (uint32_t) param->operationmode) {
+		ostringstream error;
+		error << "ERROR!: " << weightfile << " was recorded for operation mode " << fileone.header.mode << ", not " << param->operationmode << "!";
+		TraceLoadFailed(error.str(), -1);
+	}
+	int ROW = fileone.numRow;
+	int COL = fileone.numCol;
 	
 	double NormalizedMin = 0;
 	double NormalizedMax = pow(2, param->synapseBit);
@@ -1119,237 +1199,236 @@ vector<vector<double> > LoadInWeightData(const string &weightfile, int numRowPer
 	double RealMax = param->algoWeightMax;
 	double RealMin = param->algoWeightMin;
 	
-	vector<vector<double> > weight;            
+	bool xnorMode = param->XNORparallelMode || param->XNORsequentialMode;
+	int numColMatrix = param->BNNparallelMode? 2*COL : (xnorMode? COL : COL*numColPerSynapse);
+	LevelMatrix weight(ROW, numColMatrix, LevelMatrix::rowMajor);
+	weight.complementRows = xnorMode;    // XNOR: the complementary weights are virtual rows
+	// cell level index -> cell conductance
+	int cellrange = pow(2, param->cellBit);
+	if (param->BNNparallelMode || xnorMode) {
+		weight.levelValue.push_back(minConductance);
+		weight.levelValue.push_back(maxConductance);
+	} else if (cellrange > 256) {
+		TraceLoadFailed("ERROR!: cellBit > 8 is not supported by the weight level indices, please modify 'cellBit' in Param.cpp!", -1);
+	} else {
+		for (int level=0; level<cellrange; level++) {
+			double cellvalue = level;
+			weight.levelValue.push_back(cellvalue/(cellrange-1) * (maxConductance-minConductance) + minConductance);
+		}
+	}
 	// load the data into a weight matrix ...
+	bool outOfRange = false;
+	double outOfRangeWeight = 0;
+	#pragma omp parallel for copyin(param)
 	for (int row=0; row<ROW; row++) {	
-		vector<double> weightrow;
-		vector<double> weightrowb;
-		getline(fileone, lineone, '\n');              
-		istringstream iss;
-		iss.str(lineone);
-		for (int col=0; col<COL; col++) {       
-			while(getline(iss, valone, ',')){	
-				istringstream fs;
-				fs.str(valone);
-				double f=0;
-				fs >> f;	
-				//normalize weight to integer
-				double newdata = ((NormalizedMax-NormalizedMin)/(RealMax-RealMin)*(f-RealMax)+NormalizedMax);
-				if (newdata >= 0) {
-					newdata += 0.5;
-				}else {
-					newdata -= 0.5;
+		int weightrow = row;
+		int weightcol = 0;
+		int numValue;
+		vector<double> buffer(COL+1);
+		const double *rowValue = fileone.Row(row, &numValue, &buffer[0]);
+		for (int v=0; v<numValue && COL>0 && weightcol<numColMatrix; v++) {
+			double f = rowValue[v];
+			//normalize weight to integer
+			double newdata = ((NormalizedMax-NormalizedMin)/(RealMax-RealMin)*(f-RealMax)+NormalizedMax);
+			if (newdata >= 0) {
+				newdata += 0.5;
+			}else {
+				newdata -= 0.5;
+			}
+			// map and expend the weight in memory array (as cell level indices)
+			vector<double> synapsevector(numColPerSynapse);       
+			int value = newdata; 
+			
+			if (param->BNNparallelMode) {
+				if (value == 1) {
+					weight(weightrow, weightcol++) = 1;
+					weight(weightrow, weightcol++) = 0;
+				} else {
+					weight(weightrow, weightcol++) = 0;
+					weight(weightrow, weightcol++) = 1;
 				}
-				// map and expend the weight in memory array
-				int cellrange = pow(2, param->cellBit);
-				vector<double> synapsevector(numColPerSynapse);       
-				int value = newdata; 
-				
-				if (param->BNNparallelMode) {
-					if (value == 1) {
-						weightrow.push_back(maxConductance);
-						weightrow.push_back(minConductance);
-					} else {
-						weightrow.push_back(minConductance);
-						weightrow.push_back(maxConductance);
-					}
-				} else if (param->XNORparallelMode || param->XNORsequentialMode) {
-					if (value == 1) {
-						weightrow.push_back(maxConductance);
-						weightrowb.push_back(minConductance);
-					} else {
-						weightrow.push_back(minConductance);
-						weightrowb.push_back(maxConductance);
-					}
+			} else if (xnorMode) {
+				if (value == 1) {
+					weight(weightrow, weightcol++) = 1;
 				} else {
-					int remainder;   
-					for (int z=0; z<numColPerSynapse; z++) {   
-						remainder = ceil((double)(value%cellrange));
-						value = ceil((double)(value/cellrange));
-						synapsevector.insert(synapsevector.begin(), remainder);
-					}
-					for (int u=0; u<numColPerSynapse; u++) {
-						double cellvalue = synapsevector[u];
-						double conductance = cellvalue/(cellrange-1) * (maxConductance-minConductance) + minConductance;
-						weightrow.push_back(conductance);
+					weight(weightrow, weightcol++) = 0;
+				}
+			} else {
+				int remainder;   
+				for (int z=0; z<numColPerSynapse; z++) {   
+					remainder = ceil((double)(value%cellrange));
+					value = ceil((double)(value/cellrange));
+					synapsevector.insert(synapsevector.begin(), remainder);
+				}
+				for (int u=0; u<numColPerSynapse; u++) {
+					int level = synapsevector[u];
+					if (level < 0 || level >= cellrange) {
+						#pragma omp critical(LoadInWeightDataRange)
+						{
+							outOfRange = true;
+							outOfRangeWeight = f;
+						}
+						level = 0;
 					}
+					weight(weightrow, weightcol++) = level;
 				}
 			}
 		}
-		if (param->XNORparallelMode || param->XNORsequentialMode) {
-			weight.push_back(weightrow);
-			weightrow.clear();
-			weight.push_back(weightrowb);
-			weightrowb.clear();
-		} else {
-			weight.push_back(weightrow);
-			weightrow.clear();
-		}
 	}
-	fileone.close();
+	if (outOfRange) {
+		ostringstream error;
+		error << "ERROR!: weight " << outOfRangeWeight << " is out of the algorithm weight range, please check 'algoWeightMax' and 'algoWeightMin' in Param.cpp!";
+		TraceLoadFailed(error.str(), -1);
+	}
 	
+	if (cached) {
+		WriteWeightCache(cacheKey, weight);
+	}
 	return weight;
-	weight.clear();
 }
 
 
 
-vector<vector<double> > CopyArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol) {
+Matrix LoadInInputData(const string &inputfile) {
 	
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numCol; j++) {
-			copyRow.push_back(orginal[positionRow+i][positionCol+j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
+	TraceFile infile(inputfile);
+	if (!infile.good) {       
+		TraceLoadFailed("Error: the input file cannot be opened!", 1);
 	}
-	
-	return copy;
-	copy.clear();
-} 
+	return LoadInInputData(infile, 0, infile.numCol);
+}
 
 
 
-vector<vector<double> > ReshapeArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol, int numPE, int weightMatrixRow) {
+Matrix LoadInInputData(const TraceFile &infile, int colStart, int numColumn) {
 	
-	vector<vector<double> > copy;
-
-	for (int k=0; k<numPE; k++) {
-		for (int i=0; i<numRow; i++) {
-			vector<double> copyRow;
-			for (int j=0; j<numCol; j++) {
-				copyRow.push_back(orginal[positionRow+k*weightMatrixRow+i][positionCol+j]);
-			}
-			copy.push_back(copyRow);
-			copyRow.clear();
+	if (infile.binary && (infile.header.kind != traceInput || infile.header.bits != (uint32_t) param->numBitInput)) {
+		ostringstream error;
+		error << "ERROR!: " << infile.name << " is not a " << param->numBitInput << "-bit input trace!";
+		TraceLoadFailed(error.str(), -1);
+	}
+	if (infile.binary && infile.header.mode != (uint32_t) param->operationmode) {
+		ostringstream error;
+		error << "ERROR!: " << infile.name << " was recorded for operation mode " << infile.header.mode << ", not " << param->operationmode << "!";
+		TraceLoadFailed(error.str(), -1);
+	}
+	int ROWin = infile.numRow;
+	int COLin = numColumn;
+	
+	bool xnorMode = param->XNORparallelMode || param->XNORsequentialMode;
+	// the fast estimate alone (no calibration against the exact results) only reads the activated rows of each input vector, so no dense matrix is built
+	bool indexOnly = infile.sparse || (param->fastEstimate && !param->fastEstimateCalibration && !xnorMode);
+	Matrix inputvector(ROWin, COLin, indexOnly? Matrix::sparseColumns : Matrix::columnMajor);
+	inputvector.complementRows = xnorMode;     // XNOR: the complementary inputs are virtual rows
+	// load the data into inputvector ...
+	if (infile.sparse) {
+		// sparse traces are only kept as the nonzero index, read by input vector (an empty vector is an empty range)
+		inputvector.nonzeroStart.assign(COLin+1, 0);
+		vector<int> nonzeroRow(ROWin);
+		for (int inputcol=0; inputcol<COLin; inputcol++) {
+			int numNonzero = (colStart+inputcol < infile.numCol)? infile.NonzeroRows(colStart+inputcol, &nonzeroRow[0]) : 0;
+			inputvector.nonzeroRow.insert(inputvector.nonzeroRow.end(), nonzeroRow.begin(), nonzeroRow.begin() + numNonzero);
+			inputvector.nonzeroStart[inputcol+1] = inputvector.nonzeroRow.size();
 		}
+		return inputvector;
 	}
-	
-	return copy;
-	copy.clear();
-} 
-
-
-
-vector<vector<double> > LoadInInputData(const string &inputfile) {
-	
-	ifstream infile(inputfile.c_str());     
-	string inputline;
-	string inputval;
-	
-	int ROWin=0, COLin=0;      
-	if (!infile.good()) {       
-		cerr << "Error: the input file cannot be opened!" << endl;
-		exit(1);
-	}else{
-		while (getline(infile, inputline, '\n')) {      
-			ROWin++;                               
+	if (indexOnly) {
+		// the trace is read row by row: keep the nonzero columns of each row, then sort them into the index by input vector (counting sort, rows stay increasing),
+		// a nonzero value other than 1 of a conventional trace counts as 1
+		vector<vector<int> > rowNonzero(ROWin);
+		#pragma omp parallel for copyin(param)
+		for (int row=0; row<ROWin; row++) {
+			int numValue;
+			vector<double> buffer(COLin+1);
+			const double *rowValue = infile.Row(row, colStart, COLin, &numValue, &buffer[0]);
+			for (int inputcol=0; inputcol<numValue; inputcol++) {
+				double f = rowValue[inputcol];
+				if (param->BNNparallelMode? (f == 1) : (f != 0)) {
+					rowNonzero[row].push_back(inputcol);
+				}
+			}
+		}
+		inputvector.nonzeroStart.assign(COLin+1, 0);
+		for (int row=0; row<ROWin; row++) {
+			for (int n=0; n<rowNonzero[row].size(); n++) {
+				inputvector.nonzeroStart[rowNonzero[row][n]+1]++;
+			}
+		}
+		for (int inputcol=0; inputcol<COLin; inputcol++) {
+			inputvector.nonzeroStart[inputcol+1] += inputvector.nonzeroStart[inputcol];
 		}
-		infile.clear();
-		infile.seekg(0, ios::beg);    
-		if (getline(infile, inputline, '\n')) {        
-			istringstream iss (inputline);      
-			while (getline(iss, inputval, ',')) {       
-				COLin++;
+		inputvector.nonzeroRow.resize(inputvector.nonzeroStart[COLin]);
+		vector<long> next(inputvector.nonzeroStart.begin(), inputvector.nonzeroStart.end()-1);
+		for (int row=0; row<ROWin; row++) {
+			for (int n=0; n<rowNonzero[row].size(); n++) {
+				inputvector.nonzeroRow[next[rowNonzero[row][n]]++] = row;
 			}
-		}	
+		}
+		return inputvector;
 	}
-	infile.clear();
-	infile.seekg(0, ios::beg);          
-	
-	vector<vector<double> > inputvector;              
-	// load the data into inputvector ...
+	long numNonzero = 0;
+	#pragma omp parallel for copyin(param) reduction(+: numNonzero)
 	for (int row=0; row<ROWin; row++) {	
-		vector<double> inputvectorrow;
-		vector<double> inputvectorrowb;
-		getline(infile, inputline, '\n');             
-		istringstream iss;
-		iss.str(inputline);
-		for (int col=0; col<COLin; col++) {
-			while(getline(iss, inputval, ',')){	
-				istringstream fs;
-				fs.str(inputval);
-				double f=0;
-				fs >> f;
-				
-				if (param->BNNparallelMode) {
-					if (f == 1) {
-						inputvectorrow.push_back(1);
-					} else {
-						inputvectorrow.push_back(0);
-					}
-				} else if (param->XNORparallelMode || param->XNORsequentialMode) {
-					if (f == 1) {
-						inputvectorrow.push_back(1);
-						inputvectorrowb.push_back(0);
-					} else {
-						inputvectorrow.push_back(0);
-						inputvectorrowb.push_back(1);
-					}
-				} else {
-					inputvectorrow.push_back(f);
-				}
+		int inputrow = row;
+		int numValue;
+		vector<double> buffer(COLin+1);
+		const double *rowValue = infile.Row(row, colStart, COLin, &numValue, &buffer[0]);
+		for (int inputcol=0; inputcol<numValue; inputcol++) {
+			double f = rowValue[inputcol];
+			if (param->BNNparallelMode || xnorMode) {
+				inputvector(inputrow, inputcol) = (f == 1)? 1 : 0;
+			} else {
+				inputvector(inputrow, inputcol) = f;
 			}
+			numNonzero += (inputvector(inputrow, inputcol) != 0);
 		}
-		if (param->XNORparallelMode || param->XNORsequentialMode) {
-			inputvector.push_back(inputvectorrow);
-			inputvectorrow.clear();
-			inputvector.push_back(inputvectorrowb);
-			inputvectorrowb.clear();
-		} else {
-			inputvector.push_back(inputvectorrow);
-			inputvectorrow.clear();
+	}
+	
+	// index the nonzero rows of each input vector, so that the subArrays skip the zero rows of sparse (ReLU) layers,
+	// only for a density up to 1/8, where the index (4 bytes per nonzero element) is small next to the matrix (8 bytes per element)
+	if (numNonzero > (long) ROWin*COLin/8) {
+		return inputvector;
+	}
+	inputvector.nonzeroStart.assign(COLin+1, 0);
+	for (int inputcol=0; inputcol<COLin; inputcol++) {
+		for (int inputrow=0; inputrow<ROWin; inputrow++) {
+			if (inputvector(inputrow, inputcol) != 0) {
+				inputvector.nonzeroRow.push_back(inputrow);
+			}
 		}
+		inputvector.nonzeroStart[inputcol+1] = inputvector.nonzeroRow.size();
 	}
-	// close the input file ...
-	infile.close();
 	
 	return inputvector;
-	inputvector.clear();
 }
 
 
+bool StreamedLayer(const vector<vector<double> > &netStructure, int layerNumber) {
+	int l = layerNumber;
+	int numInVector = (netStructure[l][0]-netStructure[l][3]+1)/netStructure[l][7]*(netStructure[l][1]-netStructure[l][4]+1)/netStructure[l][7];
+	return param->inputChunkSize > 0 && numInVector > param->inputChunkSize;
+}
 
 
-vector<vector<double> > CopyInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow) {
-	
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numInputVector; j++) {
-			copyRow.push_back(orginal[positionRow+i][j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
+void LoadLayerTraces(const string &weightfile, const string &inputfile, bool streamed, LayerTraces *traces) {
+	traces->weight = new LevelMatrix(LoadInWeightData(weightfile, param->numRowPerSynapse, param->numColPerSynapse, param->maxConductance, param->minConductance));
+	if (!streamed) {
+		traces->input = new Matrix(LoadInInputData(inputfile));
+		return;
 	}
-	
-	return copy;
-	copy.clear();
-	
-} 
-
-
+	traces->inputFile = new TraceFile(inputfile, true);
+	if (!traces->inputFile->good) {       
+		TraceLoadFailed("Error: the input file cannot be opened!", 1);
+	}
+}
 
-vector<vector<double> > ReshapeInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow, int numPE, int weightMatrixRow) {
-	
-	vector<vector<double> > copy;
 
-	for (int k=0; k<numPE; k++) {
-		for (int i=0; i<numRow; i++) {
-			vector<double> copyRow;
-			for (int j=0; j<numInputVector; j++) {
-				copyRow.push_back(orginal[positionRow+k*weightMatrixRow+i][j]);
-			}
-			copy.push_back(copyRow);
-			copyRow.clear();
-		}
-	}
-	
-	return copy;
-	copy.clear();
-} 
+void FreeLayerTraces(LayerTraces *traces) {
+	delete traces->weight;
+	delete traces->input;
+	delete traces->inputFile;
+	*traces = LayerTraces();
+}
 
 
 
@@ -0,0 +1,241 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <immintrin.h>
+#include "ColumnKernel.h"
+
+using namespace std;
+
+/* Each kernel walks the set bits of the packed input and adds the selected conductance rows to the column sums.   */
+/* The columns are processed in register blocks and every register walks the rows in ascending order, so all the   */
+/* kernels give exactly the same column sums as the scalar loop.                                                    */
+typedef void (*AccumulateKernel)(const uint64_t *input, int numWord, const double *conductance, int stride, double *columnG);
+
+static void AccumulateScalar(const uint64_t *input, int numWord, const double *conductance, int stride, double *columnG) {
+	for (int w=0; w<numWord; w++) {
+		uint64_t bits = input[w];
+		while (bits) {
+			const double *row = conductance + (long) (w*64 + __builtin_ctzll(bits)) * stride;
+			for (int j=0; j<stride; j++) {
+				columnG[j] += row[j];
+			}
+			bits &= bits - 1;
+		}
+	}
+}
+
+__attribute__((target("sse4.2")))
+static void AccumulateSSE4(const uint64_t *input, int numWord, const double *conductance, int stride, double *columnG) {
+	int j = 0;
+	for (; j+8<=stride; j+=8) {
+		__m128d acc0 = _mm_loadu_pd(columnG+j), acc1 = _mm_loadu_pd(columnG+j+2);
+		__m128d acc2 = _mm_loadu_pd(columnG+j+4), acc3 = _mm_loadu_pd(columnG+j+6);
+		for (int w=0; w<numWord; w++) {
+			uint64_t bits = input[w];
+			while (bits) {
+				const double *row = conductance + (long) (w*64 + __builtin_ctzll(bits)) * stride + j;
+				acc0 = _mm_add_pd(acc0, _mm_loadu_pd(row));
+				acc1 = _mm_add_pd(acc1, _mm_loadu_pd(row+2));
+				acc2 = _mm_add_pd(acc2, _mm_loadu_pd(row+4));
+				acc3 = _mm_add_pd(acc3, _mm_loadu_pd(row+6));
+				bits &= bits - 1;
+			}
+		}
+		_mm_storeu_pd(columnG+j, acc0); _mm_storeu_pd(columnG+j+2, acc1);
+		_mm_storeu_pd(columnG+j+4, acc2); _mm_storeu_pd(columnG+j+6, acc3);
+	}
+}
+
+__attribute__((target("avx2")))
+static void AccumulateAVX2(const uint64_t *input, int numWord, const double *conductance, int stride, double *columnG) {
+	int j = 0;
+	for (; j+16<=stride; j+=16) {
+		__m256d acc0 = _mm256_loadu_pd(columnG+j), acc1 = _mm256_loadu_pd(columnG+j+4);
+		__m256d acc2 = _mm256_loadu_pd(columnG+j+8), acc3 = _mm256_loadu_pd(columnG+j+12);
+		for (int w=0; w<numWord; w++) {
+			uint64_t bits = input[w];
+			while (bits) {
+				const double *row = conductance + (long) (w*64 + __builtin_ctzll(bits)) * stride + j;
+				acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(row));
+				acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(row+4));
+				acc2 = _mm256_add_pd(acc2, _mm256_loadu_pd(row+8));
+				acc3 = _mm256_add_pd(acc3, _mm256_loadu_pd(row+12));
+				bits &= bits - 1;
+			}
+		}
+		_mm256_storeu_pd(columnG+j, acc0); _mm256_storeu_pd(columnG+j+4, acc1);
+		_mm256_storeu_pd(columnG+j+8, acc2); _mm256_storeu_pd(columnG+j+12, acc3);
+	}
+	for (; j<stride; j+=4) {
+		__m256d acc = _mm256_loadu_pd(columnG+j);
+		for (int w=0; w<numWord; w++) {
+			uint64_t bits = input[w];
+			while (bits) {
+				acc = _mm256_add_pd(acc, _mm256_loadu_pd(conductance + (long) (w*64 + __builtin_ctzll(bits)) * stride + j));
+				bits &= bits - 1;
+			}
+		}
+		_mm256_storeu_pd(columnG+j, acc);
+	}
+}
+
+__attribute__((target("avx512f")))
+static void AccumulateAVX512(const uint64_t *input, int numWord, const double *conductance, int stride, double *columnG) {
+	int j = 0;
+	for (; j+32<=stride; j+=32) {
+		__m512d acc0 = _mm512_loadu_pd(columnG+j), acc1 = _mm512_loadu_pd(columnG+j+8);
+		__m512d acc2 = _mm512_loadu_pd(columnG+j+16), acc3 = _mm512_loadu_pd(columnG+j+24);
+		for (int w=0; w<numWord; w++) {
+			uint64_t bits = input[w];
+			while (bits) {
+				const double *row = conductance + (long) (w*64 + __builtin_ctzll(bits)) * stride + j;
+				acc0 = _mm512_add_pd(acc0, _mm512_loadu_pd(row));
+				acc1 = _mm512_add_pd(acc1, _mm512_loadu_pd(row+8));
+				acc2 = _mm512_add_pd(acc2, _mm512_loadu_pd(row+16));
+				acc3 = _mm512_add_pd(acc3, _mm512_loadu_pd(row+24));
+				bits &= bits - 1;
+			}
+		}
+		_mm512_storeu_pd(columnG+j, acc0); _mm512_storeu_pd(columnG+j+8, acc1);
+		_mm512_storeu_pd(columnG+j+16, acc2); _mm512_storeu_pd(columnG+j+24, acc3);
+	}
+	for (; j<stride; j+=8) {
+		__m512d acc = _mm512_loadu_pd(columnG+j);
+		for (int w=0; w<numWord; w++) {
+			uint64_t bits = input[w];
+			while (bits) {
+				acc = _mm512_add_pd(acc, _mm512_loadu_pd(conductance + (long) (w*64 + __builtin_ctzll(bits)) * stride + j));
+				bits &= bits - 1;
+			}
+		}
+		_mm512_storeu_pd(columnG+j, acc);
+	}
+}
+
+static AccumulateKernel accumulateKernel = AccumulateScalar;
+static const char *accumulateKernelName = "scalar";
+static volatile double benchmarkSink;		// the benchmark checksums are stored here, so the kernel calls are not optimized away
+
+void ColumnKernelInitialize() {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		accumulateKernel = AccumulateAVX512;
+		accumulateKernelName = "avx512";
+	} else if (__builtin_cpu_supports("avx2")) {
+		accumulateKernel = AccumulateAVX2;
+		accumulateKernelName = "avx2";
+	} else if (__builtin_cpu_supports("sse4.2")) {
+		accumulateKernel = AccumulateSSE4;
+		accumulateKernelName = "sse4";
+	} else {
+		accumulateKernel = AccumulateScalar;
+		accumulateKernelName = "scalar";
+	}
+}
+
+
+const char* ColumnKernelName() {
+	return accumulateKernelName;
+}
+
+
+int ColumnKernelStride(int numCol) {
+	return (numCol+7)/8*8;
+}
+
+
+void ColumnKernelAccumulate(const uint64_t *input, int numWord, const double *conductance, int stride, double *columnG) {
+	accumulateKernel(input, numWord, conductance, stride, columnG);
+}
+
+
+void ColumnKernelBenchmark() {
+	vector<AccumulateKernel> kernels;
+	vector<const char*> names;
+	__builtin_cpu_init();
+	kernels.push_back(AccumulateScalar); names.push_back("scalar");
+	if (__builtin_cpu_supports("sse4.2")) { kernels.push_back(AccumulateSSE4); names.push_back("sse4"); }
+	if (__builtin_cpu_supports("avx2")) { kernels.push_back(AccumulateAVX2); names.push_back("avx2"); }
+	if (__builtin_cpu_supports("avx512f")) { kernels.push_back(AccumulateAVX512); names.push_back("avx512"); }
+	
+	mt19937 benchGen(0);
+	uniform_real_distribution<double> conductanceDist(1e-6, 1e-5);
+	const int numPattern = 64;      // # of different input vectors cycled through, 50% row activity
+	
+	cout << "Column kernel throughput (single core, square subArray, 50% row activity), selected kernel: " << accumulateKernelName << endl;
+	for (int numRow=64; numRow<=512; numRow*=2) {
+		int numCol = numRow;
+		int stride = ColumnKernelStride(numCol);
+		int numWord = (numRow+63)/64;
+		vector<double> conductance((long) numRow*stride, 0);
+		for (int i=0; i<numRow; i++) {
+			for (int j=0; j<numCol; j++) {
+				conductance[(long) i*stride+j] = conductanceDist(benchGen);
+			}
+		}
+		vector<uint64_t> input((long) numPattern*numWord);
+		for (size_t p=0; p<input.size(); p++) {
+			input[p] = ((uint64_t) benchGen() << 32) | benchGen();
+		}
+		vector<double> columnG(stride);
+		
+		cout << "numRowSubArray = " << numRow << ":";
+		for (size_t k=0; k<kernels.size(); k++) {
+			long numVector = 0;
+			double checksum = 0;
+			double elapsed = 0;
+			auto start = chrono::steady_clock::now();
+			while (elapsed < 0.2) {
+				for (int p=0; p<numPattern; p++) {
+					fill(columnG.begin(), columnG.end(), 0);
+					kernels[k](&input[(long) p*numWord], numWord, &conductance[0], stride, &columnG[0]);
+					checksum += columnG[0];
+				}
+				numVector += numPattern;
+				elapsed = chrono::duration<double>(chrono::steady_clock::now()-start).count();
+			}
+			cout << "  " << names[k] << " " << numVector/elapsed << " vectors/s";
+			benchmarkSink = checksum;
+		}
+		cout << endl;
+	}
+}
@@ -0,0 +1,240 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <omp.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include "CsvParser.h"
+
+using namespace std;
+
+double csvBytesTotal = 0;
+double csvSecondsTotal = 0;
+
+static double ParseValue(const char *begin, const char *end) {
+	// same result as istringstream >> double for numeric fields, 0 if the field does not start with a number
+	int length = end - begin;
+	if (length == 1 && *begin >= '0' && *begin <= '9') {
+		return *begin - '0';
+	}
+	char buffer[64];
+	string field;
+	const char *text;
+	if (length < (int) sizeof(buffer)) {		// strtod needs a terminated string, the mapping is not
+		memcpy(buffer, begin, length);
+		buffer[length] = '\0';
+		text = buffer;
+	} else {
+		field.assign(begin, end);
+		text = field.c_str();
+	}
+	char *stop;
+	double value = strtod(text, &stop);
+	return (stop == text)? 0 : value;
+}
+
+static void ParseChunk(const char *begin, const char *end, vector<double> &value, vector<size_t> &rowStart) {
+	const char *line = begin;
+	while (line < end) {
+		const char *lineEnd = (const char *) memchr(line, '\n', end - line);
+		if (lineEnd == NULL) {
+			lineEnd = end;
+		}
+		rowStart.push_back(value.size());
+		// getline(line, value, ','): the fields between commas, an empty last field is not a value
+		const char *field = line;
+		while (field < lineEnd) {
+			const char *fieldEnd = (const char *) memchr(field, ',', lineEnd - field);
+			if (fieldEnd == NULL) {
+				fieldEnd = lineEnd;
+			}
+			value.push_back(ParseValue(field, fieldEnd));
+			field = fieldEnd + 1;
+		}
+		line = lineEnd + 1;
+	}
+	rowStart.push_back(value.size());
+}
+
+CsvParser::CsvParser(const string &filename, bool _indexed) {
+	good = false;
+	numRow = numCol = 0;
+	fileSize = parseTime = 0;
+	indexed = _indexed;
+	mapping = NULL;
+	mappingSize = 0;
+	
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0 || S_ISDIR(status.st_mode)) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return;
+	}
+	good = true;
+	double start = omp_get_wtime();
+	size_t size = status.st_size;
+	const char *data = NULL;
+	if (size > 0) {
+		data = (const char *) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			good = false;
+			return;
+		}
+		madvise((void *) data, size, indexed? MADV_NORMAL : MADV_SEQUENTIAL);
+	}
+	
+	if (indexed) {
+		// the lines as ParseChunk cuts them, the number of values of the first line as it counts them
+		for (const char *line = data; line < data + size; ) {
+			const char *end = (const char *) memchr(line, '\n', data + size - line);
+			if (end == NULL) {
+				end = data + size;
+			}
+			lineStart.push_back(line - data);
+			lineEnd.push_back(end - data);
+			line = end + 1;
+		}
+		numRow = lineStart.size();
+		if (numRow > 0) {
+			for (const char *field = data + lineStart[0]; field < data + lineEnd[0]; numCol++) {
+				const char *fieldEnd = (const char *) memchr(field, ',', data + lineEnd[0] - field);
+				field = (fieldEnd == NULL)? data + lineEnd[0] + 1 : fieldEnd + 1;
+			}
+		}
+		cursorOffset = lineStart;
+		cursorCol.assign(numRow, 0);
+		mapping = data;
+		mappingSize = size;
+		close(fd);
+		fileSize = size;
+		parseTime = omp_get_wtime() - start;
+		#pragma omp critical
+		{
+			csvBytesTotal += fileSize;
+			csvSecondsTotal += parseTime;
+		}
+		return;
+	}
+	
+	// cut the file at line boundaries, one chunk per thread
+	int numChunk = (size > 0)? max(1, min(omp_get_max_threads(), (int) (size/(1 << 20)) + 1)) : 0;
+	vector<size_t> chunkStart(numChunk+1, size);
+	for (int c=0; c<numChunk; c++) {
+		size_t position = max(size*c/numChunk, (c > 0)? chunkStart[c-1] : 0);
+		if (c > 0 && position < size) {
+			const char *lineEnd = (const char *) memchr(data + position, '\n', size - position);
+			position = (lineEnd == NULL)? size : lineEnd - data + 1;
+		}
+		chunkStart[c] = position;
+	}
+	chunkValue.resize(numChunk);
+	chunkRowStart.resize(numChunk);
+	#pragma omp parallel for schedule(static, 1)
+	for (int c=0; c<numChunk; c++) {
+		ParseChunk(data + chunkStart[c], data + chunkStart[c+1], chunkValue[c], chunkRowStart[c]);
+	}
+	
+	chunkFirstRow.resize(numChunk+1);
+	for (int c=0; c<numChunk; c++) {
+		chunkFirstRow[c] = numRow;
+		numRow += chunkRowStart[c].size() - 1;
+	}
+	chunkFirstRow[numChunk] = numRow;
+	if (numRow > 0) {
+		Row(0, &numCol);
+	}
+	
+	if (size > 0) {
+		munmap((void *) data, size);
+	}
+	close(fd);
+	fileSize = size;
+	parseTime = omp_get_wtime() - start;
+	#pragma omp critical
+	{
+		csvBytesTotal += fileSize;
+		csvSecondsTotal += parseTime;
+	}
+}
+
+CsvParser::~CsvParser() {
+	if (mapping) {
+		munmap((void *) mapping, mappingSize);
+	}
+}
+
+const double *CsvParser::Row(int row, int *size) const {
+	int c = upper_bound(chunkFirstRow.begin(), chunkFirstRow.end(), row) - chunkFirstRow.begin() - 1;
+	int r = row - chunkFirstRow[c];
+	*size = chunkRowStart[c][r+1] - chunkRowStart[c][r];
+	return chunkValue[c].empty()? NULL : &chunkValue[c][0] + chunkRowStart[c][r];
+}
+
+const double *CsvParser::Row(int row, int colStart, int numValue, int *size, double *buffer) const {
+	const char *end = mapping + lineEnd[row];
+	const char *field = mapping + lineStart[row];
+	int col = 0;
+	if (cursorCol[row] <= colStart) {
+		field = mapping + cursorOffset[row];
+		col = cursorCol[row];
+	}
+	for (; col<colStart && field<end; col++) {
+		const char *fieldEnd = (const char *) memchr(field, ',', end - field);
+		field = (fieldEnd == NULL)? end + 1 : fieldEnd + 1;
+	}
+	*size = 0;
+	for (; *size<numValue && field<end; col++) {
+		const char *fieldEnd = (const char *) memchr(field, ',', end - field);
+		if (fieldEnd == NULL) {
+			fieldEnd = end;
+		}
+		buffer[(*size)++] = ParseValue(field, fieldEnd);
+		field = fieldEnd + 1;
+	}
+	cursorOffset[row] = min(field, end) - mapping;
+	cursorCol[row] = col;
+	return buffer;
+}
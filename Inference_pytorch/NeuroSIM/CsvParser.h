@@ -0,0 +1,86 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef CSVPARSER_H_
+#define CSVPARSER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Single-pass parser of the comma separated trace files (weights, inputs, network structure).
+   The file is memory-mapped and cut at line boundaries into one chunk per OpenMP thread.
+   Rows and values follow getline(file, line, '\n') / getline(line, value, ',') / istringstream >> double.
+   An indexed parser (streamed input traces, param->inputChunkSize) only finds the lines and keeps the file mapped,
+   the values are parsed when a column range of a row is read */
+class CsvParser {
+public:
+	CsvParser(const string &filename, bool _indexed = false);
+	virtual ~CsvParser();
+
+	/* Functions */
+	const double *Row(int row, int *size) const;	/* values of a row and their number (not indexed) */
+	const double *Row(int row, int colStart, int numValue, int *size, double *buffer) const;	/* indexed: values colStart .. colStart+numValue-1 of a row
+																								   parsed into buffer, a row is read by one thread at a time */
+
+	/* Properties */
+	bool good;			/* false if the file cannot be opened */
+	bool indexed;		/* the values are parsed by column range when read */
+	int numRow;			/* # of lines */
+	int numCol;			/* # of values in the first line */
+	double fileSize;	/* Unit: byte */
+	double parseTime;	/* Unit: s */
+
+private:
+	vector<vector<double> > chunkValue;		/* values of each chunk */
+	vector<vector<size_t> > chunkRowStart;	/* start of each row of a chunk in chunkValue, plus the end of the last row */
+	vector<int> chunkFirstRow;				/* first row of each chunk, plus numRow */
+	
+	/* indexed */
+	const char *mapping;
+	size_t mappingSize;
+	vector<size_t> lineStart, lineEnd;		/* each row in the mapping */
+	mutable vector<size_t> cursorOffset;	/* the field after the last one read in each row, so reading the columns in order scans each line once */
+	mutable vector<int> cursorCol;			/* the column of that field */
+};
+
+extern double csvBytesTotal, csvSecondsTotal;		/* all files parsed so far, for the load throughput report */
+
+#endif /* CSVPARSER_H_ */
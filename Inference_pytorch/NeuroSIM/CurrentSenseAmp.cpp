@@ -75,6 +75,10 @@ void CurrentSenseAmp::Initialize(int _numCol, bool _parallel, bool _rowbyrow, do
 	Rref = R_start + (double) R_index/2;
 	
 	initialized = true;
+	
+	if (param->senseAmpTable) {
+		BuildColumnTable();
+	}
 }
 
 void CurrentSenseAmp::CalculateUnitArea() {
@@ -115,10 +119,14 @@ void CurrentSenseAmp::CalculateLatency(const vector<double> &columnResistance, d
 		double Group = numCol/numColMuxed;
 		double LatencyCol = 0;
 		readLatency = 0;
+		columnLatency.resize(columnResistance.size());
+		columnPower.resize(columnResistance.size());
 
-		for (double j=0; j<columnResistance.size(); j++){
+		for (int j=0; j<columnResistance.size(); j++){
 			double T_Col = 0;
-			T_Col = GetColumnLatency(columnResistance[j]);
+			T_Col = LookupColumnLatency(columnResistance[j]);
+			columnLatency[j] = T_Col;
+			columnPower[j] = LookupColumnPower(columnResistance[j]);
 			LatencyCol = max(LatencyCol, T_Col);
 			if (LatencyCol < 5e-10) {
 				LatencyCol = 5e-10;
@@ -131,16 +139,21 @@ void CurrentSenseAmp::CalculateLatency(const vector<double> &columnResistance, d
 	}
 }
 
-void CurrentSenseAmp::CalculatePower(const vector<double> &columnResistance, double numRead) {
+void CurrentSenseAmp::CalculatePower(const vector<double> &columnResistance, double numRead, bool reuseColumn) {
 	if (!initialized) {
 		cout << "[CurrentSenseAmp] Error: Require initialization first!" << endl;
 	} else {
 		leakage = 0;
 		readDynamicEnergy = 0;
-		for (double i=0; i<columnResistance.size(); i++) {
+		for (int i=0; i<columnResistance.size(); i++) {
 			double P_Col = 0, T_Col = 0;
-			T_Col = GetColumnLatency(columnResistance[i]);
-			P_Col = GetColumnPower(columnResistance[i]);
+			if (reuseColumn) {	// evaluated by CalculateLatency with the same columnResistance
+				T_Col = columnLatency[i];
+				P_Col = columnPower[i];
+			} else {
+				T_Col = LookupColumnLatency(columnResistance[i]);
+				P_Col = LookupColumnPower(columnResistance[i]);
+			}
 			readDynamicEnergy += T_Col*P_Col;
 		}
 		readDynamicEnergy *= numRead;
@@ -148,6 +161,41 @@ void CurrentSenseAmp::CalculatePower(const vector<double> &columnResistance, dou
 }
 
 
+void CurrentSenseAmp::BuildColumnTable() {
+	// tabulate the fitted column latency and power over log(columnRes) from 1 ohm to 10 Gohm
+	// the latency fit jumps where Rref/columnRes crosses 20, 0.05 and 0.9, these cells keep the original equations
+	static bool reported = false;
+	latencyTable.Initialize(1, 1e10, 8192);
+	powerTable.Initialize(1, 1e10, 8192);
+	latencyTable.MarkBreakpoint(Rref/20/(0.5/param->readVoltage));
+	latencyTable.MarkBreakpoint(Rref/0.05/(0.5/param->readVoltage));
+	latencyTable.MarkBreakpoint(Rref/0.9/(0.5/param->readVoltage));
+	latencyTable.Build(this, &CurrentSenseAmp::GetColumnLatency);
+	powerTable.Build(this, &CurrentSenseAmp::GetColumnPower);
+	// the tables of concurrent contexts (param->concurrentLayers) are built in parallel, only the first one reports
+	#pragma omp critical(CurrentSenseAmpTableReport)
+	if (!reported) {
+		cout << "[CurrentSenseAmp] Column latency/power table max relative error: " << latencyTable.maxError*100 << "%, " << powerTable.maxError*100 << "%" << endl;
+		reported = true;
+	}
+}
+
+double CurrentSenseAmp::LookupColumnLatency(double columnRes) {
+	double Column_Latency;
+	if (!latencyTable.Lookup(columnRes, &Column_Latency)) {
+		Column_Latency = GetColumnLatency(columnRes);
+	}
+	return Column_Latency;
+}
+
+double CurrentSenseAmp::LookupColumnPower(double columnRes) {
+	double Column_Power;
+	if (!powerTable.Lookup(columnRes, &Column_Power)) {
+		Column_Power = GetColumnPower(columnRes);
+	}
+	return Column_Power;
+}
+
 double CurrentSenseAmp::GetColumnLatency(double columnRes) {
 	double Column_Latency = 0;
 	double up_bound = 3, mid_bound = 1.1, low_bound = 0.9;
@@ -42,6 +42,7 @@
 
 #include <vector>
 #include "FunctionUnit.h"
+#include "InterpolationTable.h"
 #include "typedef.h"
 #include "InputParameter.h"
 #include "Technology.h"
@@ -62,10 +63,13 @@ public:
 	void Initialize(int _numCol, bool _parallel, bool _rowbyrow, double _clkFreq, int _numReadCellPerOperationNeuro);
 	void CalculateArea(double _widthCurrentSenseAmp);
 	void CalculateLatency(const vector<double> &columnResistance, double numColMuxed, double numRead);
-	void CalculatePower(const vector<double> &columnResistance, double numRead);
+	void CalculatePower(const vector<double> &columnResistance, double numRead, bool reuseColumn = false);
 	void CalculateUnitArea();
 	double GetColumnLatency(double columnRes);
 	double GetColumnPower(double columnRes);
+	void BuildColumnTable();
+	double LookupColumnLatency(double columnRes);
+	double LookupColumnPower(double columnRes);
 
 
 	/* Properties */
@@ -79,6 +83,8 @@ public:
 	bool parallel;
 	bool rowbyrow;
 	double clkFreq, Rref;
+	vector<double> columnLatency, columnPower;	/* per-column results of the last CalculateLatency, reused by CalculatePower(reuseColumn) */
+	InterpolationTable latencyTable, powerTable;	/* column latency and power over log(columnRes), only built with param->senseAmpTable */
 	int numReadCellPerOperationNeuro;
 };
 
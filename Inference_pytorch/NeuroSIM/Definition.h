@@ -39,12 +39,5 @@
 // This file cannot be compiled alone. Only include this file in main.cpp.
 
 /* Global variables */
-Param *param = new Param(); // Parameter set
-
-/* Random number generator engine */
-std::mt19937 gen;
-
-InputParameter inputParameter;
-Technology tech;
-MemCell cell;
+Param *param = NULL; // Parameter set of the simulation context bound to this thread (SimulationContext::Bind), the rest of the state is in the context
 
@@ -0,0 +1,112 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <cmath>
+#include "constant.h"
+#include "formula.h"
+#include "Param.h"
+#include "SimulationContext.h"
+#include "DeviceVariation.h"
+
+using namespace std;
+
+#define MIN_VARIATION_FACTOR	1e-3	// Gaussian model: floor of the conductance factor, a cell drawn at or below zero conductance is nearly open
+
+void Philox4x32(uint32_t counter[4], const uint32_t key[2]) {
+	// Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (SC'11), 10 rounds
+	uint32_t k0 = key[0], k1 = key[1];
+	for (int round=0; round<10; round++) {
+		uint64_t product0 = (uint64_t) 0xD2511F53 * counter[0];
+		uint64_t product1 = (uint64_t) 0xCD9E8D57 * counter[2];
+		uint32_t c0 = (uint32_t) (product1 >> 32) ^ counter[1] ^ k0;
+		uint32_t c1 = (uint32_t) product1;
+		uint32_t c2 = (uint32_t) (product0 >> 32) ^ counter[3] ^ k1;
+		uint32_t c3 = (uint32_t) product0;
+		counter[0] = c0;
+		counter[1] = c1;
+		counter[2] = c2;
+		counter[3] = c3;
+		k0 += 0x9E3779B9;
+		k1 += 0xBB67AE85;
+	}
+}
+
+double VariationNormal(int trial, int layer, int row, int col) {
+	uint32_t counter[4] = {(uint32_t) col, (uint32_t) row, (uint32_t) layer, (uint32_t) trial};
+	uint32_t key[2] = {(uint32_t) param->variationSeed, 0};
+	Philox4x32(counter, key);
+	// two uniform variates with 53 random bits, the first one in (0, 1] for the logarithm
+	double u1 = ((((uint64_t) counter[0] << 32 | counter[1]) >> 11) + 1) * (1.0/9007199254740992.0);
+	double u2 = (((uint64_t) counter[2] << 32 | counter[3]) >> 11) * (1.0/9007199254740992.0);
+	return sqrt(-2*log(u1)) * cos(2*M_PI*u2);
+}
+
+double VariationFactor(int trial, int layer, int row, int col, int level, int numLevel) {
+	double sigma = param->variationSigma;
+	if (param->variationSigmaLowLevel >= 0 && numLevel > 1) {
+		// per-level sigma: from variationSigmaLowLevel at the lowest conductance level to variationSigma at the highest one
+		sigma = param->variationSigmaLowLevel + (param->variationSigma - param->variationSigmaLowLevel) * level/(numLevel-1);
+	}
+	double z = VariationNormal(trial, layer, row, col);
+	if (param->variationModel == 2) {
+		return MAX(1 + sigma*z, MIN_VARIATION_FACTOR);		// Gaussian, as the vari option of the Python layers, but the cell resistance stays finite
+	}
+	return exp(sigma*z);		// lognormal, the nominal conductance is the median
+}
+
+void ApplyDeviceVariation(const SimulationContext& ctx, const LevelMatrixView &weight, MemCell& cell, double *conductance, int stride) {
+	if (cell.memCellType != Type::RRAM && cell.memCellType != Type::FeFET) {
+		return;		// the SRAM cell conductance does not depend on the weight
+	}
+	const vector<double> &levelConductance = weight.LevelValue();
+	int numLevel = levelConductance.size();
+	for (int i=0; i<weight.numRow; i++) {
+		const uint8_t *weightRow = weight.Row(i);
+		bool complemented = weight.RowComplemented(i);
+		int row = weight.MatrixRow(i);
+		double *conductanceRow = conductance + i*stride;
+		for (int j=0; j<weight.numCol; j++) {
+			// the cell resistance is in series with the rest of the path (access device and wires), only the cell part is scaled
+			int level = complemented? numLevel-1-weightRow[j] : weightRow[j];
+			double cellResistance = 1.0/levelConductance[level];
+			double pathResistance = 1.0/conductanceRow[j] - cellResistance;
+			double factor = VariationFactor(ctx.variationTrial, ctx.variationLayer, row, weight.MatrixCol(j), level, numLevel);
+			conductanceRow[j] = 1.0/(cellResistance/factor + pathResistance);
+		}
+	}
+}
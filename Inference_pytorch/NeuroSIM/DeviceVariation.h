@@ -0,0 +1,66 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef DEVICEVARIATION_H_
+#define DEVICEVARIATION_H_
+
+#include <stdint.h>
+#include "MemCell.h"
+#include "MatrixView.h"
+
+class SimulationContext;
+
+/* Monte Carlo device-to-device variation (param->monteCarloTrials). In trial t, the conductance of every eNVM cell is scaled by a
+   random factor drawn from a counter-based generator (Philox4x32-10) keyed by (t, layer, weight matrix row, weight matrix column):
+   a cell gets the same factor whichever thread, PE or streamed chunk of input vectors evaluates it, and each trial is reproducible alone */
+
+/*** Functions ***/
+/* Philox4x32-10 block of the 128-bit counter under the 64-bit key, 4 random words returned in counter */
+void Philox4x32(uint32_t counter[4], const uint32_t key[2]);
+
+/* Standard normal variate of (trial, layer, row, col), Box-Muller transform of one Philox block */
+double VariationNormal(int trial, int layer, int row, int col);
+
+/* Conductance factor of a cell at the given level (of numLevel): lognormal or Gaussian (param->variationModel) with the sigma of that level */
+double VariationFactor(int trial, int layer, int row, int col, int level, int numLevel);
+
+/* Perturb the effective cell conductances of GetCellConductance (stride entries per row) for ctx.variationTrial and ctx.variationLayer,
+   the access device and wire resistance in series with each cell are kept */
+void ApplyDeviceVariation(const SimulationContext& ctx, const LevelMatrixView &weight, MemCell& cell, double *conductance, int stride);
+
+#endif /* DEVICEVARIATION_H_ */
@@ -182,8 +182,8 @@ void HTree::CalculateLatency(int x_init, int y_init, int x_end, int y_end, doubl
 		double resOnRep = CalculateOnResistance(widthInvN, NMOS, inputParameter.temperature, tech) + CalculateOnResistance(widthInvP, PMOS, inputParameter.temperature, tech);
 		
 		if (((!x_init) && (!y_init)) || ((!x_end) && (!y_end))) {      // root-leaf communicate (fixed addr)
+			double wireWidth, unitLengthWireResistance = 0;     // read uninitialized by the first stage before (stack contents), 0 moves the results by about 1e-6 relative; the next stages use the previous wire
 			for (int i=0; i<(numStage-1)/2; i++) {                     // ignore main bus here, but need to count until last stage (diff from area calculation)
-				double wireWidth, unitLengthWireResistance;
 				unitLatencyRep = 0.7*(resOnRep*(capInvInput+capInvOutput+unitLengthWireCap*minDist)+0.5*unitLengthWireResistance*minDist*unitLengthWireCap*minDist+unitLengthWireResistance*minDist*capInvInput)/minDist;
 				unitLatencyWire = 0.7*unitLengthWireResistance*minDist*unitLengthWireCap*minDist/minDist;
 			
@@ -256,8 +256,8 @@ void HTree::CalculateLatency(int x_init, int y_init, int x_end, int y_end, doubl
 				}
 			}
 			/*** count the following stage ***/
+			double wireWidth, unitLengthWireResistance = 0;     // read uninitialized by the first stage before (stack contents), 0 moves the results by about 1e-6 relative; the next stages use the previous wire
 			for (int i=find_stage+1; i<(numStage-1)/2; i++) {  
-				double wireWidth, unitLengthWireResistance;
 				unitLatencyRep = 0.7*(resOnRep*(capInvInput+capInvOutput+unitLengthWireCap*minDist)+0.5*unitLengthWireResistance*minDist*unitLengthWireCap*minDist+unitLengthWireResistance*minDist*capInvInput)/minDist;
 				unitLatencyWire = 0.7*unitLengthWireResistance*minDist*unitLengthWireCap*minDist/minDist;
 			
@@ -0,0 +1,83 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <cmath>
+#include <vector>
+#include "InterpolationTable.h"
+
+using namespace std;
+
+InterpolationTable::InterpolationTable() {
+	numPoint = 0;
+	xMin = step = invStep = 0;
+	maxError = 0;
+}
+
+void InterpolationTable::Initialize(double _resMin, double _resMax, int _numPoint) {
+	numPoint = _numPoint;
+	xMin = log(_resMin);
+	step = (log(_resMax) - xMin)/(numPoint - 1);
+	invStep = 1/step;
+	value.assign(numPoint, 0);
+	exactCell.assign(numPoint, false);
+}
+
+void InterpolationTable::MarkBreakpoint(double columnRes) {
+	int k = (int) floor((log(columnRes) - xMin)*invStep);
+	for (int i=k-1; i<=k+1; i++) {
+		if (i >= 0 && i < numPoint) {
+			exactCell[i] = true;
+		}
+	}
+}
+
+bool InterpolationTable::Lookup(double columnRes, double *result) const {
+	if (numPoint == 0) {
+		return false;
+	}
+	double t = (log(columnRes) - xMin)*invStep;
+	if (!(t >= 0 && t < numPoint-1)) {		// also rejects NaN
+		return false;
+	}
+	int k = (int) t;
+	if (exactCell[k]) {
+		return false;
+	}
+	*result = value[k] + (t - k)*(value[k+1] - value[k]);
+	return true;
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef INTERPOLATIONTABLE_H_
+#define INTERPOLATIONTABLE_H_
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/* Piecewise-linear table of a column model over x = log(columnRes), built once in Initialize of the sense amps */
+class InterpolationTable {
+public:
+	InterpolationTable();
+	virtual ~InterpolationTable() {}
+
+	/* Functions */
+	void Initialize(double _resMin, double _resMax, int _numPoint);
+	void MarkBreakpoint(double columnRes);		/* the cells around a discontinuity of the model are always evaluated exactly */
+	bool Lookup(double columnRes, double *result) const;	/* false if the table is not built, columnRes is outside the table or in a breakpoint cell */
+
+	/* Tabulate model->function at the nodes and measure the max relative error against it inside every cell */
+	template <class Model>
+	void Build(Model *model, double (Model::*function)(double)) {
+		for (int k=0; k<numPoint; k++) {
+			value[k] = (model->*function)(exp(xMin + k*step));
+		}
+		maxError = 0;
+		for (int k=0; k<numPoint-1; k++) {
+			if (exactCell[k]) {
+				continue;
+			}
+			for (int s=1; s<4; s++) {
+				double columnRes = exp(xMin + (k + 0.25*s)*step);
+				double exact = (model->*function)(columnRes);
+				double interpolated = 0;
+				if (Lookup(columnRes, &interpolated) && exact != 0) {
+					maxError = max(maxError, fabs(interpolated - exact)/fabs(exact));
+				}
+			}
+		}
+	}
+
+	/* Properties */
+	int numPoint;			/* Number of nodes, 0 if the table is not built */
+	double xMin, step, invStep;
+	double maxError;		/* Max relative error against the model */
+	vector<double> value;
+	vector<bool> exactCell;
+};
+
+#endif /* INTERPOLATIONTABLE_H_ */
@@ -0,0 +1,120 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include "Matrix.h"
+
+using namespace std;
+
+template <class T>
+BasicMatrix<T>::BasicMatrix() {
+	numRow = numCol = 0;
+	layout = rowMajor;
+	rowStep = colStep = 0;
+	data = NULL;
+	complementRows = false;
+}
+
+template <class T>
+BasicMatrix<T>::BasicMatrix(int _numRow, int _numCol, Layout _layout) {
+	data = NULL;
+	complementRows = false;
+	Allocate(_numRow, _numCol, _layout);
+}
+
+template <class T>
+BasicMatrix<T>::BasicMatrix(const BasicMatrix &other) {
+	data = NULL;
+	*this = other;
+}
+
+template <class T>
+BasicMatrix<T> &BasicMatrix<T>::operator=(const BasicMatrix &other) {
+	if (this != &other) {
+		Allocate(other.numRow, other.numCol, other.layout);
+		long size = (layout == rowMajor)? (long) numRow*rowStep : (long) numCol*colStep;
+		if (size > 0) {
+			memcpy(data, other.data, size*sizeof(T));
+		}
+		levelValue = other.levelValue;
+		complementRows = other.complementRows;
+		nonzeroStart = other.nonzeroStart;
+		nonzeroRow = other.nonzeroRow;
+	}
+	return *this;
+}
+
+template <class T>
+BasicMatrix<T>::~BasicMatrix() {
+	free(data);
+}
+
+template <class T>
+void BasicMatrix<T>::Allocate(int _numRow, int _numCol, Layout _layout) {
+	free(data);
+	numRow = _numRow;
+	numCol = _numCol;
+	layout = _layout;
+	int elementPerLine = 64/sizeof(T);
+	int leading = (layout == rowMajor)? numCol : numRow;
+	int padded = (leading + elementPerLine - 1)/elementPerLine*elementPerLine;
+	long size = (long) padded*((layout == rowMajor)? numRow : numCol);
+	if (layout == sparseColumns) {
+		size = 0;
+		rowStep = colStep = 0;
+	} else if (layout == rowMajor) {
+		rowStep = padded;
+		colStep = 1;
+	} else {
+		rowStep = 1;
+		colStep = padded;
+	}
+	data = NULL;
+	if (size > 0 && posix_memalign((void **) &data, 64, size*sizeof(T)) != 0) {
+		cout << "ERROR: cannot allocate a " << numRow << "x" << numCol << " matrix" << endl;
+		exit(-1);
+	}
+	if (size > 0) {
+		memset(data, 0, size*sizeof(T));
+	}
+}
+
+template class BasicMatrix<double>;
+template class BasicMatrix<uint8_t>;
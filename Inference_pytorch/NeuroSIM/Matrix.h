@@ -0,0 +1,90 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef MATRIX_H_
+#define MATRIX_H_
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Dense matrix in one 64-byte aligned allocation, used for the layer weights and input traces.
+   Weights are stored row-major, input traces column-major (input-vector-major) so that one input vector is contiguous,
+   sparse input traces (traceSparse) only as their nonzero index */
+template <class T>
+class BasicMatrix {
+public:
+	enum Layout {
+		rowMajor,
+		columnMajor,
+		sparseColumns	/* no dense storage (data is NULL), the elements are given by the nonzero index and are all 1 */
+	};
+
+	BasicMatrix();
+	BasicMatrix(int _numRow, int _numCol, Layout _layout);
+	BasicMatrix(const BasicMatrix &other);
+	BasicMatrix &operator=(const BasicMatrix &other);
+	virtual ~BasicMatrix();
+
+	/* Functions */
+	T &operator()(int r, int c) {
+		return data[(long) r*rowStep + (long) c*colStep];
+	}
+	T operator()(int r, int c) const {
+		return data[(long) r*rowStep + (long) c*colStep];
+	}
+
+	/* Properties */
+	int numRow, numCol;
+	Layout layout;
+	int rowStep, colStep;	/* Distance between two rows / two columns, the leading dimension is padded to a multiple of 64 bytes */
+	T *data;				/* Zero initialized */
+	vector<double> levelValue;	/* LevelMatrix: the value (cell conductance) of each level index */
+	bool complementRows;	/* XNOR: each stored row is followed by a virtual complementary row (1 - value), seen through MatrixView */
+	vector<long> nonzeroStart;	/* Input traces: the nonzero rows of column c are nonzeroRow[nonzeroStart[c]] .. nonzeroRow[nonzeroStart[c+1]-1], empty if not indexed */
+	vector<int> nonzeroRow;		/* Increasing within each column */
+
+private:
+	void Allocate(int _numRow, int _numCol, Layout _layout);
+};
+
+typedef BasicMatrix<double> Matrix;
+typedef BasicMatrix<uint8_t> LevelMatrix;		/* Weights as cell level indices, resolved through levelValue */
+
+#endif /* MATRIX_H_ */
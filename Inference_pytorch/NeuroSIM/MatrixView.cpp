@@ -0,0 +1,119 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <iostream>
+#include <stdlib.h>
+#include "MatrixView.h"
+
+using namespace std;
+
+template <class T>
+BasicMatrixView<T>::BasicMatrixView() {
+	matrix = NULL;
+	numRow = numCol = 0;
+	rowOffset = rowStart = colOffset = 0;
+	rowBlock = INT_MAX;
+	rowBlockStride = 0;
+}
+
+template <class T>
+BasicMatrixView<T>::BasicMatrixView(const BasicMatrix<T> &_matrix) {
+	matrix = &_matrix;
+	numRow = _matrix.complementRows? 2*_matrix.numRow : _matrix.numRow;
+	numCol = _matrix.numCol;
+	rowOffset = rowStart = colOffset = 0;
+	rowBlock = INT_MAX;
+	rowBlockStride = 0;
+}
+
+template <class T>
+BasicMatrixView<T> BasicMatrixView<T>::Sub(int positionRow, int positionCol, int _numRow, int _numCol) const {
+	BasicMatrixView view = *this;
+	view.rowStart += positionRow;
+	view.colOffset += positionCol;
+	view.numRow = _numRow;
+	view.numCol = _numCol;
+	return view;
+}
+
+template <class T>
+BasicMatrixView<T> BasicMatrixView<T>::Reshape(int positionRow, int positionCol, int _numRow, int _numCol, int numBlock, int blockStride) const {
+	if (rowBlock != INT_MAX) {
+		cout << "ERROR: MatrixView cannot reshape a view that is already reshaped" << endl;
+		exit(-1);
+	}
+	BasicMatrixView view = *this;
+	view.rowOffset = rowOffset + rowStart + positionRow;
+	view.rowStart = 0;
+	view.rowBlock = _numRow;
+	view.rowBlockStride = blockStride;
+	view.colOffset += positionCol;
+	view.numRow = _numRow*numBlock;
+	view.numCol = _numCol;
+	return view;
+}
+
+template <class T>
+int BasicMatrixView<T>::NonzeroRows(int c, int *rows) const {
+	const int *first = matrix->nonzeroRow.data() + matrix->nonzeroStart[colOffset+c];
+	const int *last = matrix->nonzeroRow.data() + matrix->nonzeroStart[colOffset+c+1];
+	int count = 0;
+	// each block of the view is a range of consecutive matrix rows
+	for (int r=0; r<numRow && first<last; ) {
+		int length = min(rowBlock - (rowStart+r)%rowBlock, numRow - r);
+		int matrixRow = MatrixRow(r);
+		const int *begin = lower_bound(first, last, matrixRow);
+		const int *end = lower_bound(begin, last, matrixRow + length);
+		for (const int *p=begin; p<end; p++) {
+			rows[count++] = r + (*p - matrixRow);
+		}
+		r += length;
+	}
+	return count;
+}
+
+template <class T>
+T BasicMatrixView<T>::SparseElement(int r, int c) const {
+	int row = matrix->complementRows? MatrixRow(r)/2 : MatrixRow(r);
+	const int *first = matrix->nonzeroRow.data() + matrix->nonzeroStart[colOffset+c];
+	const int *last = matrix->nonzeroRow.data() + matrix->nonzeroStart[colOffset+c+1];
+	return binary_search(first, last, row)? (T) 1 : (T) 0;
+}
+
+template class BasicMatrixView<double>;
+template class BasicMatrixView<uint8_t>;
@@ -0,0 +1,114 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef MATRIXVIEW_H_
+#define MATRIXVIEW_H_
+
+#include <climits>
+#include <algorithm>
+#include "Matrix.h"
+
+using namespace std;
+
+/* Non-owning view of a block of a layer matrix (weights or input vectors) loaded in ChipCalculatePerformance,
+   passed down the Chip->Tile->PE->SubArray hierarchy instead of copying each slice.
+   Row r of the view is row rowOffset + ((rowStart+r)/rowBlock)*rowBlockStride + (rowStart+r)%rowBlock of the matrix,
+   counting the virtual complementary rows of an XNOR matrix (stored row k is row 2k, its complement row 2k+1) */
+template <class T>
+class BasicMatrixView {
+public:
+	BasicMatrixView();
+	BasicMatrixView(const BasicMatrix<T> &_matrix);
+	virtual ~BasicMatrixView() {}
+
+	/* Functions */
+	BasicMatrixView Sub(int positionRow, int positionCol, int _numRow, int _numCol) const;	/* numRow x numCol block starting at (positionRow, positionCol) of this view */
+	BasicMatrixView Reshape(int positionRow, int positionCol, int _numRow, int _numCol, int numBlock, int blockStride) const;	/* numBlock blocks of numRow rows, blockStride rows apart, stacked */
+
+	int MatrixRow(int r) const {
+		int row = rowStart + r;
+		return rowOffset + (row/rowBlock)*rowBlockStride + row%rowBlock;
+	}
+	int MatrixCol(int c) const {
+		return colOffset + c;
+	}
+	const T *Element(int r, int c) const {		/* stored element, a virtual complementary row gives the element of its stored row */
+		int row = matrix->complementRows? MatrixRow(r)/2 : MatrixRow(r);
+		return matrix->data + (long) row*matrix->rowStep + (long) (colOffset + c)*matrix->colStep;
+	}
+	const T *Row(int r) const {		/* row-major matrix: the numCol stored elements of row r are contiguous */
+		return Element(r, 0);
+	}
+	bool RowComplemented(int r) const {
+		return matrix->complementRows && MatrixRow(r)%2 == 1;
+	}
+	T operator()(int r, int c) const {
+		T value = IndexOnly()? SparseElement(r, c) : *Element(r, c);
+		return RowComplemented(r)? (T) 1 - value : value;
+	}
+	int RowStep() const {
+		return matrix->rowStep;
+	}
+	bool RowContiguous() const {	/* the rows of the view are stored evenly spaced (RowStep apart) in the matrix */
+		return !IndexOnly() && !matrix->complementRows && (rowStart%rowBlock) + numRow <= rowBlock;
+	}
+	const vector<double> &LevelValue() const {
+		return matrix->levelValue;
+	}
+	bool NonzeroIndexed() const {	/* NonzeroRows is available: the matrix has a nonzero index and no complementary rows */
+		return !matrix->nonzeroStart.empty() && !matrix->complementRows;
+	}
+	int NonzeroRows(int c, int *rows) const;	/* rows of column c with a nonzero element in increasing order, returns their number */
+	bool IndexOnly() const {	/* sparseColumns matrix: no stored elements (Element cannot be used), every nonzero element is 1 */
+		return matrix->layout == BasicMatrix<T>::sparseColumns;
+	}
+
+	/* Properties */
+	int numRow, numCol;
+
+private:
+	T SparseElement(int r, int c) const;	/* element of a sparseColumns matrix, looked up in the nonzero index */
+
+	const BasicMatrix<T> *matrix;
+	int rowOffset, rowStart, rowBlock, rowBlockStride, colOffset;
+};
+
+typedef BasicMatrixView<double> MatrixView;
+typedef BasicMatrixView<uint8_t> LevelMatrixView;
+
+#endif /* MATRIXVIEW_H_ */
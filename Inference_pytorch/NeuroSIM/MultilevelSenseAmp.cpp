@@ -81,6 +81,10 @@ void MultilevelSenseAmp::Initialize(int _numCol, int _levelOutput, double _clkFr
 		widthNmos = MIN_NMOS_SIZE * tech.featureSize;
 		widthPmos = tech.pnSizeRatio * MIN_NMOS_SIZE * tech.featureSize;
 		initialized = true;
+		
+		if (param->senseAmpTable) {
+			BuildColumnTable();
+		}
 	}
 }
 
@@ -134,9 +138,13 @@ void MultilevelSenseAmp::CalculateLatency(const vector<double> &columnResistance
 	} else {
 		readLatency = 0;
 		double LatencyCol = 0;
-		for (double j=0; j<columnResistance.size(); j++){
+		columnLatency.resize(columnResistance.size());
+		columnPower.resize(columnResistance.size());
+		for (int j=0; j<columnResistance.size(); j++){
 			double T_Col = 0;
-			T_Col = GetColumnLatency(columnResistance[j]);
+			T_Col = LookupColumnLatency(columnResistance[j]);
+			columnLatency[j] = T_Col;
+			columnPower[j] = LookupColumnPower(columnResistance[j]);
 			if (columnResistance[j] == columnResistance[j]) {
 				LatencyCol = max(LatencyCol, T_Col);
 			} else {
@@ -153,17 +161,25 @@ void MultilevelSenseAmp::CalculateLatency(const vector<double> &columnResistance
 	}
 }
 
-void MultilevelSenseAmp::CalculatePower(const vector<double> &columnResistance, double numRead) {
+void MultilevelSenseAmp::CalculatePower(const vector<double> &columnResistance, double numRead, bool reuseColumn) {
 	if (!initialized) {
 		cout << "[MultilevelSenseAmp] Error: Require initialization first!" << endl;
 	} else {
 		leakage = 0;
 		readDynamicEnergy = 0;
 		
+		if (!reuseColumn) {	// otherwise columnLatency and columnPower are already evaluated by CalculateLatency with the same columnResistance
+			columnLatency.resize(columnResistance.size());
+			columnPower.resize(columnResistance.size());
+			for (int j=0; j<columnResistance.size(); j++){
+				columnLatency[j] = LookupColumnLatency(columnResistance[j]);
+				columnPower[j] = LookupColumnPower(columnResistance[j]);
+			}
+		}
+		
 		double LatencyCol = 0;
-		for (double j=0; j<columnResistance.size(); j++){
-			double T_Col = 0;
-			T_Col = GetColumnLatency(columnResistance[j]);
+		for (int j=0; j<columnResistance.size(); j++){
+			double T_Col = columnLatency[j];
 			if (columnResistance[j] == columnResistance[j]) {
 				LatencyCol = max(LatencyCol, T_Col);
 			} else {
@@ -176,9 +192,8 @@ void MultilevelSenseAmp::CalculatePower(const vector<double> &columnResistance,
 			}
 		}
 
-		for (double i=0; i<columnResistance.size(); i++) {
-			double P_Col = 0;
-			P_Col = GetColumnPower(columnResistance[i]);
+		for (int i=0; i<columnResistance.size(); i++) {
+			double P_Col = columnPower[i];
 			readDynamicEnergy += MAX(P_Col*LatencyCol, 0);
 		}
 		readDynamicEnergy *= numRead;
@@ -190,6 +205,43 @@ void MultilevelSenseAmp::PrintProperty(const char* str) {
 }
 
 
+void MultilevelSenseAmp::BuildColumnTable() {
+	// tabulate the fitted column latency and power over log(columnRes) from 1 ohm to 10 Gohm
+	// the latency fit jumps where Rref/columnRes crosses 20, 0.05 and 0.9, these cells keep the original equations
+	static bool reported = false;
+	latencyTable.Initialize(1, 1e10, 8192);
+	powerTable.Initialize(1, 1e10, 8192);
+	for (int i=1; i<levelOutput-1; i++) {
+		latencyTable.MarkBreakpoint(Rref[i]/20/(0.5/param->readVoltage));
+		latencyTable.MarkBreakpoint(Rref[i]/0.05/(0.5/param->readVoltage));
+		latencyTable.MarkBreakpoint(Rref[i]/0.9/(0.5/param->readVoltage));
+	}
+	latencyTable.Build(this, &MultilevelSenseAmp::GetColumnLatency);
+	powerTable.Build(this, &MultilevelSenseAmp::GetColumnPower);
+	// the tables of concurrent contexts (param->concurrentLayers) are built in parallel, only the first one reports
+	#pragma omp critical(MultilevelSenseAmpTableReport)
+	if (!reported) {
+		cout << "[MultilevelSenseAmp] Column latency/power table max relative error: " << latencyTable.maxError*100 << "%, " << powerTable.maxError*100 << "%" << endl;
+		reported = true;
+	}
+}
+
+double MultilevelSenseAmp::LookupColumnLatency(double columnRes) {
+	double Column_Latency;
+	if (!latencyTable.Lookup(columnRes, &Column_Latency)) {
+		Column_Latency = GetColumnLatency(columnRes);
+	}
+	return Column_Latency;
+}
+
+double MultilevelSenseAmp::LookupColumnPower(double columnRes) {
+	double Column_Power;
+	if (!powerTable.Lookup(columnRes, &Column_Power)) {
+		Column_Power = GetColumnPower(columnRes);
+	}
+	return Column_Power;
+}
+
 double MultilevelSenseAmp::GetColumnLatency(double columnRes) {
 	double Column_Latency = 0;
 	double up_bound = 3, mid_bound = 1.1, low_bound = 0.9;
@@ -45,6 +45,7 @@
 #include "Technology.h"
 #include "MemCell.h"
 #include "FunctionUnit.h"
+#include "InterpolationTable.h"
 #include "CurrentSenseAmp.h"
 
 using namespace std;
@@ -62,9 +63,12 @@ public:
 	void Initialize(int _numCol, int _levelOutput, double _clkFreq, int _numReadCellPerOperationNeuro, bool _parallel);
 	void CalculateArea(double heightArray, double widthArray, AreaModify _option);
 	void CalculateLatency(const vector<double> &columnResistance, double numColMuxed, double numRead);
-	void CalculatePower(const vector<double> &columnResistance, double numRead);
+	void CalculatePower(const vector<double> &columnResistance, double numRead, bool reuseColumn = false);
 	double GetColumnLatency(double columnRes);
 	double GetColumnPower(double columnRes);
+	void BuildColumnTable();
+	double LookupColumnLatency(double columnRes);
+	double LookupColumnPower(double columnRes);
 
 	/* Properties */
 	bool initialized;		/* Initialization flag */
@@ -78,6 +82,8 @@ public:
 	double clkFreq, widthNmos, widthPmos;
 	int numReadCellPerOperationNeuro;
 	vector<double> Rref;
+	vector<double> columnLatency, columnPower;	/* per-column results of the last CalculateLatency, reused by CalculatePower(reuseColumn) */
+	InterpolationTable latencyTable, powerTable;	/* column latency and power over log(columnRes), only built with param->senseAmpTable */
 
 	CurrentSenseAmp currentSenseAmp;
 };
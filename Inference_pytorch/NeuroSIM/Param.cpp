@@ -100,6 +100,36 @@ Param::Param() {
 								// A speed-up degree upper bound: when there is no idle period during each layer --> no need to further fold the system clock
 								// This idle period is defined by IFM sizes and data flow, the actual process latency of each layer may be different due to extra peripheries
 
+	/*** simulator options (do not change the hardware results) ***/
+	columnKernelBenchmark = false;      // true: report the column kernel throughput (vectors/s per core) for numRowSubArray from 64 to 512
+	inputChunkSize = 0;                 // > 0: load and simulate the input vectors of a layer in chunks of this size, bounding the input memory to weightMatrixRow*inputChunkSize*numBitInput doubles
+	                                    // (a CSV trace is only indexed by line and each chunk parsed from it, the weight matrix is still loaded whole; with inputSampling each chunk is sampled separately)
+	tracePrefetch = true;               // true: load the traces of the next layer in a background thread while the current layer is simulated (at most two layers in memory)
+	weightCacheDir = "";                // not empty: keep the mapped weight matrices in this directory, keyed by the weight trace content and the mapping settings
+	concurrentLayers = 1;               // > 1: simulate up to this many layers at the same time, each on its own copy of the chip (its traces loaded by its task, no tracePrefetch)
+	                                    // (within a layer, the subArrays of all its tiles and PEs run as tasks on the threads, whatever this option)
+	reproducibilityCheck = false;       // true: simulate every layer and Monte Carlo trial again on a single thread and check that the results are bit-identical (doubles the run-time), check_threads.sh compares whole runs
+	
+	/*** sense amp tables (approximate the hardware results, the max error of the tables is reported) ***/
+	senseAmpTable = false;              // true: sense amp column latency/power interpolated in tables built at initialization, false: fitted equations
+	
+	/*** input vector sampling (estimates the hardware results, 95% confidence interval reported for each layer) ***/
+	inputSampling = false;              // true: simulate a stratified (by row activity) random subset of the input vectors of each subArray
+	inputSampleSize = 256;              // # of sampled input vectors per subArray (at least 2 per activity stratum, so more than this when there are over inputSampleSize/2 strata)
+	inputSampleError = 0;               // if > 0, double the sample until the 95% confidence half-width of each subArray is below this relative error
+	
+	/*** analytical fast estimate (per subArray row-activity and column-conductance histograms instead of per input vector evaluation) ***/
+	fastEstimate = false;               // true: report the fast estimate instead of the exact per input vector results (the input traces are only loaded as their nonzero index)
+	fastEstimateCalibration = false;    // true: also run the fast estimate for each layer and report its relative error against the exact results
+	fastEstimateBins = 1;               // # of bins of activated rows evaluated per subArray besides the input vectors without any (1: a single evaluation of the active vectors, numRowSubArray: one per # of activated rows)
+	
+	/*** Monte Carlo device-to-device variation (mean, p5 and p95 of the trials reported in addition to the nominal results) ***/
+	monteCarloTrials = 0;               // > 0: simulate the network this many more times, each time with randomly perturbed eNVM cell conductances (the layers of all trials run in parallel, on at least one copy of the chip per thread)
+	variationModel = 1;                 // 1: lognormal (ln G with standard deviation variationSigma), 2: Gaussian (relative standard deviation variationSigma, as vari of the Python layers)
+	variationSigma = 0.1;               // sigma of the conductance variation of each cell
+	variationSigmaLowLevel = -1;        // >= 0: per-level sigma, this one at the lowest conductance level and linear up to variationSigma at the highest (< 0: variationSigma for all levels)
+	variationSeed = 0;                  // key of the counter-based generator, each trial only depends on this seed and its trial number
+	
 	/*** algorithm weight range, the default wrapper (based on WAGE) has fixed weight range of (-1, 1) ***/
 	algoWeightMax = 1;
 	algoWeightMin = -1;
@@ -39,6 +39,8 @@
 #ifndef PARAM_H_
 #define PARAM_H_
 
+#include <string>
+
 class Param {
 public:
 	Param();
@@ -52,6 +54,19 @@ public:
 	int relaxArrayCellHeight, relaxArrayCellWidth;
 	
 	bool globalBufferType, tileBufferType, peBufferType, chipActivation, reLu, novelMapping, pipeline;
+	bool senseAmpTable, columnKernelBenchmark;
+	int inputChunkSize;
+	bool tracePrefetch;
+	std::string weightCacheDir;
+	int concurrentLayers;
+	bool reproducibilityCheck;
+	bool inputSampling;
+	int inputSampleSize;
+	double inputSampleError;
+	bool fastEstimate, fastEstimateCalibration;
+	int fastEstimateBins;
+	int monteCarloTrials, variationModel, variationSeed;
+	double variationSigma, variationSigmaLowLevel;
 	int globalBufferCoreSizeRow, globalBufferCoreSizeCol, tileBufferCoreSizeRow, tileBufferCoreSizeCol;																								
 	
 	double clkFreq, featuresize, readNoise, resistanceOn, resistanceOff, maxConductance, minConductance;
@@ -75,4 +90,9 @@ public:
 	double AR, Rho, wireLengthRow, wireLengthCol, unitLengthWireResistance, wireResistanceRow, wireResistanceCol;
 };
 
+/* Parameter set of the SimulationContext bound to the calling thread (SimulationContext::Bind),
+   OpenMP parallel regions that read it pass it on to their threads with copyin(param) */
+extern Param *param;
+#pragma omp threadprivate(param)
+
 #endif
\ No newline at end of file
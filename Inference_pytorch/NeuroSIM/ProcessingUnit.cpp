@@ -41,8 +41,15 @@
 #include <fstream>
 #include <string>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <vector>
 #include <sstream>
+#include <unordered_map>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <omp.h>
 #include "Bus.h"
 #include "SubArray.h"
 #include "constant.h"
@@ -52,34 +59,103 @@
 #include "AdderTree.h"
 #include "Bus.h"
 #include "DFF.h"
+#include "ColumnKernel.h"
+#include "DeviceVariation.h"
+#include "SimulationContext.h"
 
 using namespace std;
 
 extern Param *param;
 
-AdderTree *adderTreeNM;
-Bus *busInputNM;
-Bus *busOutputNM;
-DFF *bufferInputNM;
-DFF *bufferOutputNM;
+/*** identical input vectors of one subArray are evaluated once: key is the packed input bit-plane + activityRowRead ***/
+struct InputPatternHash {
+	size_t operator()(const vector<uint64_t> &pattern) const {
+		uint64_t h = 14695981039346656037ULL;
+		for (int i=0; i<pattern.size(); i++) {
+			h = (h ^ pattern[i]) * 1099511628211ULL;
+			h ^= h >> 29;
+		}
+		return (size_t) h;
+	}
+};
+
+/*** one subArray evaluated by ProcessingUnitCalculatePerformance: its weights and inputs, the estimate and the statistics of SubArrayEstimate ***/
+struct SubArrayJob {
+	SubArrayJob(const LevelMatrixView &_memory, const MatrixView &_input): memory(_memory), input(_input), 
+		numInputVectorTotal(0), numInputVectorSimulated(0), numInputPattern(0), inputSampleLatencyError(4, 0), inputSampleEnergy(4, 0), inputSampleEnergyVariance(4, 0) {}
+	LevelMatrixView memory;
+	MatrixView input;
+	vector<double> estimate;
+	double numInputVectorTotal, numInputVectorSimulated, numInputPattern;
+	vector<double> inputSampleLatencyError, inputSampleEnergy, inputSampleEnergyVariance;	/* total, ADC, accumulation, other */
+};
+
+static void EstimateSubArrays(SimulationContext& ctx, SubArray *subArray, vector<SubArrayJob> &job, int numInVector, MemCell& cell);
+static void SubArrayResult(SimulationContext& ctx, const SubArrayJob &job, double *readLatency, double *readDynamicEnergy, double *leakage, 
+								double *latencyADC, double *latencyAccum, double *latencyOther, double *energyADC, double *energyAccum, double *energyOther);
+
+/*** per-cell and per-column kernels, specialized on cell type, access type and read mode and selected in ProcessingUnitInitialize ***/
+template <Type::MemCellType memCellType, CellAccessType accessType>
+static void CellConductanceKernel(const LevelMatrixView &weight, MemCell& cell, double resCellAccess, double *conductance, int stride) {
+	double wireResistanceRow = param->wireResistanceRow;
+	double resistanceAccess = cell.resistanceAccess;
+	// weights are cell level indices, the cell resistance of each level is looked up
+	const vector<double> &levelConductance = weight.LevelValue();
+	// XNOR: a virtual complementary row looks up the complementary level (min <-> max conductance)
+	double levelResistance[256], complementResistance[256];
+	int numLevel = levelConductance.size();
+	for (int level=0; level<numLevel; level++) {
+		levelResistance[level] = (double) 1.0/levelConductance[level];
+		complementResistance[numLevel-1-level] = levelResistance[level];
+	}
+	for (int i=0; i<weight.numRow; i++) {
+		const uint8_t *weightRow = weight.Row(i);
+		const double *rowResistance = weight.RowComplemented(i)? complementResistance : levelResistance;
+		double *conductanceRow = conductance + i*stride;
+		if (memCellType == Type::SRAM) {
+			// SRAM: weight value do not affect sense energy --> read energy calculated in subArray.cpp (based on wireRes wireCap etc)
+			double totalWireResistance = (double) (resCellAccess + param->wireResistanceCol);
+			for (int j=0; j<weight.numCol; j++) {
+				conductanceRow[j] = (double) 1.0/totalWireResistance;
+			}
+		} else {	// eNVM
+			double wireResistanceCol = (weight.numRow - i) * param->wireResistanceCol;
+			for (int j=0; j<weight.numCol; j++) {
+				double totalWireResistance = rowResistance[weightRow[j]] + (j + 1) * wireResistanceRow + wireResistanceCol;
+				if (memCellType == Type::RRAM && accessType == CMOS_access) {
+					totalWireResistance += resistanceAccess;
+				}
+				conductanceRow[j] = (double) 1.0/totalWireResistance;
+			}
+		}
+	}
+}
 
-AdderTree *adderTreeCM;
-Bus *busInputCM;
-Bus *busOutputCM;
-DFF *bufferInputCM;
-DFF *bufferOutputCM;
+template <bool sequentialRead>
+static void ColumnResistanceKernel(const double *columnG, int numCol, int activatedRow, double *resistance) {
+	for (int j=0; j<numCol; j++) {
+		if (sequentialRead) {	// eNVM sequential read senses the average cell conductance of the activated rows
+			resistance[j] = (double) 1.0/((double) columnG[j]/activatedRow);
+		} else {
+			resistance[j] = (double) 1.0/columnG[j];
+		}
+	}
+}
 
-void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParameter, Technology& tech, MemCell& cell, int _numSubArrayRowNM, int _numSubArrayColNM, int _numSubArrayRowCM, int _numSubArrayColCM) {
+static void NoCellConductanceKernel(const LevelMatrixView &weight, MemCell& cell, double resCellAccess, double *conductance, int stride) {
+}
+
+void ProcessingUnitInitialize(SimulationContext& ctx, SubArray *& subArray, InputParameter& inputParameter, Technology& tech, MemCell& cell, int _numSubArrayRowNM, int _numSubArrayColNM, int _numSubArrayRowCM, int _numSubArrayColCM) {
 
 	/*** circuit level parameters ***/
-	switch(param->memcelltype) {
+	switch(ctx.config.memcelltype) {
 		case 3:     cell.memCellType = Type::FeFET; break;
 		case 2:	    cell.memCellType = Type::RRAM; break;
 		case 1:	    cell.memCellType = Type::SRAM; break;
 		case -1:	break;
 		default:	exit(-1);
 	}
-	switch(param->accesstype) {
+	switch(ctx.config.accesstype) {
 		case 4:	    cell.accessType = none_access;  break;
 		case 3:	    cell.accessType = diode_access; break;
 		case 2:	    cell.accessType = BJT_access;   break;
@@ -88,7 +164,7 @@ void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParamet
 		default:	exit(-1);
 	}				
 					
-	switch(param->transistortype) {
+	switch(ctx.config.transistortype) {
 		case 3:	    inputParameter.transistorType = TFET;          break;
 		case 2:	    inputParameter.transistorType = FET_2D;        break;
 		case 1:	    inputParameter.transistorType = conventional;  break;
@@ -96,71 +172,91 @@ void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParamet
 		default:	exit(-1);
 	}
 	
-	switch(param->deviceroadmap) {
+	switch(ctx.config.deviceroadmap) {
 		case 2:	    inputParameter.deviceRoadmap = LSTP;  break;
 		case 1:	    inputParameter.deviceRoadmap = HP;    break;
 		case -1:	break;
 		default:	exit(-1);
 	}
 	
+	ColumnKernelInitialize();
+	if (cell.memCellType == Type::RRAM) {
+		if (cell.accessType == CMOS_access) {
+			ctx.cellConductanceKernel = CellConductanceKernel<Type::RRAM, CMOS_access>;
+		} else {
+			ctx.cellConductanceKernel = CellConductanceKernel<Type::RRAM, none_access>;
+		}
+	} else if (cell.memCellType == Type::FeFET) {
+		ctx.cellConductanceKernel = CellConductanceKernel<Type::FeFET, none_access>;
+	} else if (cell.memCellType == Type::SRAM) {
+		ctx.cellConductanceKernel = CellConductanceKernel<Type::SRAM, none_access>;
+	} else {
+		ctx.cellConductanceKernel = NoCellConductanceKernel;
+	}
+	if ((cell.memCellType == Type::RRAM || cell.memCellType == Type::FeFET) && !ctx.config.parallelRead) {
+		ctx.columnResistanceKernel = ColumnResistanceKernel<true>;
+	} else {
+		ctx.columnResistanceKernel = ColumnResistanceKernel<false>;
+	}
+	
 	subArray = new SubArray(inputParameter, tech, cell);
-	adderTreeNM = new AdderTree(inputParameter, tech, cell);
-	busInputNM = new Bus(inputParameter, tech, cell);
-	busOutputNM = new Bus(inputParameter, tech, cell);
-	bufferInputNM = new DFF(inputParameter, tech, cell);
-	bufferOutputNM = new DFF(inputParameter, tech, cell);
-	adderTreeCM = new AdderTree(inputParameter, tech, cell);
-	busInputCM = new Bus(inputParameter, tech, cell);
-	busOutputCM = new Bus(inputParameter, tech, cell);
-	bufferInputCM = new DFF(inputParameter, tech, cell);
-	bufferOutputCM = new DFF(inputParameter, tech, cell);
+	ctx.adderTreeNM = new AdderTree(inputParameter, tech, cell);
+	ctx.busInputNM = new Bus(inputParameter, tech, cell);
+	ctx.busOutputNM = new Bus(inputParameter, tech, cell);
+	ctx.bufferInputNM = new DFF(inputParameter, tech, cell);
+	ctx.bufferOutputNM = new DFF(inputParameter, tech, cell);
+	ctx.adderTreeCM = new AdderTree(inputParameter, tech, cell);
+	ctx.busInputCM = new Bus(inputParameter, tech, cell);
+	ctx.busOutputCM = new Bus(inputParameter, tech, cell);
+	ctx.bufferInputCM = new DFF(inputParameter, tech, cell);
+	ctx.bufferOutputCM = new DFF(inputParameter, tech, cell);
 		
 	/* Create SubArray object and link the required global objects (not initialization) */
-	inputParameter.temperature = param->temp;   // Temperature (K)
-	inputParameter.processNode = param->technode;    // Technology node
+	inputParameter.temperature = ctx.config.temp;   // Temperature (K)
+	inputParameter.processNode = ctx.config.technode;    // Technology node
 	tech.Initialize(inputParameter.processNode, inputParameter.deviceRoadmap, inputParameter.transistorType);
 	
-	cell.resistanceOn = param->resistanceOn;	                                // Ron resistance at Vr in the reported measurement data (need to recalculate below if considering the nonlinearity)
-	cell.resistanceOff = param->resistanceOff;	                                // Roff resistance at Vr in the reported measurement dat (need to recalculate below if considering the nonlinearity)
+	cell.resistanceOn = ctx.config.resistanceOn;	                                // Ron resistance at Vr in the reported measurement data (need to recalculate below if considering the nonlinearity)
+	cell.resistanceOff = ctx.config.resistanceOff;	                                // Roff resistance at Vr in the reported measurement dat (need to recalculate below if considering the nonlinearity)
 	cell.resistanceAvg = (cell.resistanceOn + cell.resistanceOff)/2;            // Average resistance (for energy estimation)
-	cell.readVoltage = param->readVoltage;	                                    // On-chip read voltage for memory cell
-	cell.readPulseWidth = param->readPulseWidth;
-	cell.accessVoltage = param->accessVoltage;                                       // Gate voltage for the transistor in 1T1R
-	cell.resistanceAccess = param->resistanceAccess;
-	cell.featureSize = param->featuresize; 
+	cell.readVoltage = ctx.config.readVoltage;	                                    // On-chip read voltage for memory cell
+	cell.readPulseWidth = ctx.config.readPulseWidth;
+	cell.accessVoltage = ctx.config.accessVoltage;                                       // Gate voltage for the transistor in 1T1R
+	cell.resistanceAccess = ctx.config.resistanceAccess;
+	cell.featureSize = ctx.config.featuresize; 
 
 	if (cell.memCellType == Type::SRAM) {   // SRAM
-		cell.heightInFeatureSize = param->heightInFeatureSizeSRAM;                   // Cell height in feature size
-		cell.widthInFeatureSize = param->widthInFeatureSizeSRAM;                     // Cell width in feature size
-		cell.widthSRAMCellNMOS = param->widthSRAMCellNMOS;
-		cell.widthSRAMCellPMOS = param->widthSRAMCellPMOS;
-		cell.widthAccessCMOS = param->widthAccessCMOS;
-		cell.minSenseVoltage = param->minSenseVoltage;
+		cell.heightInFeatureSize = ctx.config.heightInFeatureSizeSRAM;                   // Cell height in feature size
+		cell.widthInFeatureSize = ctx.config.widthInFeatureSizeSRAM;                     // Cell width in feature size
+		cell.widthSRAMCellNMOS = ctx.config.widthSRAMCellNMOS;
+		cell.widthSRAMCellPMOS = ctx.config.widthSRAMCellPMOS;
+		cell.widthAccessCMOS = ctx.config.widthAccessCMOS;
+		cell.minSenseVoltage = ctx.config.minSenseVoltage;
 	} else {
-		cell.heightInFeatureSize = (cell.accessType==CMOS_access)? param->heightInFeatureSize1T1R : param->heightInFeatureSizeCrossbar;         // Cell height in feature size
-		cell.widthInFeatureSize = (cell.accessType==CMOS_access)? param->widthInFeatureSize1T1R : param->widthInFeatureSizeCrossbar;            // Cell width in feature size
+		cell.heightInFeatureSize = (cell.accessType==CMOS_access)? ctx.config.heightInFeatureSize1T1R : ctx.config.heightInFeatureSizeCrossbar;         // Cell height in feature size
+		cell.widthInFeatureSize = (cell.accessType==CMOS_access)? ctx.config.widthInFeatureSize1T1R : ctx.config.widthInFeatureSizeCrossbar;            // Cell width in feature size
 	} 
 
-	subArray->XNORparallelMode = param->XNORparallelMode;               
-	subArray->XNORsequentialMode = param->XNORsequentialMode;             
-	subArray->BNNparallelMode = param->BNNparallelMode;                
-	subArray->BNNsequentialMode = param->BNNsequentialMode;              
-	subArray->conventionalParallel = param->conventionalParallel;                  
-	subArray->conventionalSequential = param->conventionalSequential;                 
-	subArray->numRow = param->numRowSubArray;
-	subArray->numCol = param->numRowSubArray;
-	subArray->levelOutput = param->levelOutput;
-	subArray->numColMuxed = param->numColMuxed;               // How many columns share 1 read circuit (for neuro mode with analog RRAM) or 1 S/A (for memory mode or neuro mode with digital RRAM)
-    subArray->clkFreq = param->clkFreq;                       // Clock frequency
-	subArray->relaxArrayCellHeight = param->relaxArrayCellHeight;
-	subArray->relaxArrayCellWidth = param->relaxArrayCellWidth;
-	subArray->numReadPulse = param->numBitInput;
-	subArray->avgWeightBit = param->cellBit;
-	subArray->numCellPerSynapse = param->numColPerSynapse;
+	subArray->XNORparallelMode = ctx.config.XNORparallelMode;               
+	subArray->XNORsequentialMode = ctx.config.XNORsequentialMode;             
+	subArray->BNNparallelMode = ctx.config.BNNparallelMode;                
+	subArray->BNNsequentialMode = ctx.config.BNNsequentialMode;              
+	subArray->conventionalParallel = ctx.config.conventionalParallel;                  
+	subArray->conventionalSequential = ctx.config.conventionalSequential;                 
+	subArray->numRow = ctx.config.numRowSubArray;
+	subArray->numCol = ctx.config.numRowSubArray;
+	subArray->levelOutput = ctx.config.levelOutput;
+	subArray->numColMuxed = ctx.config.numColMuxed;               // How many columns share 1 read circuit (for neuro mode with analog RRAM) or 1 S/A (for memory mode or neuro mode with digital RRAM)
+    subArray->clkFreq = ctx.config.clkFreq;                       // Clock frequency
+	subArray->relaxArrayCellHeight = ctx.config.relaxArrayCellHeight;
+	subArray->relaxArrayCellWidth = ctx.config.relaxArrayCellWidth;
+	subArray->numReadPulse = ctx.config.numBitInput;
+	subArray->avgWeightBit = ctx.config.cellBit;
+	subArray->numCellPerSynapse = ctx.config.numColPerSynapse;
 	subArray->spikingMode = NONSPIKING;
 	
-	int numRow = param->numRowSubArray;
-	int numCol = param->numColSubArray;
+	int numRow = ctx.config.numRowSubArray;
+	int numCol = ctx.config.numColSubArray;
 	
 	if (subArray->numColMuxed > numCol) {                      // Set the upperbound of numColMuxed
 		subArray->numColMuxed = numCol;
@@ -180,45 +276,45 @@ void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParamet
 	int numSubArrayColCM = _numSubArrayColCM;
 
 	/*** initialize modules ***/
-	subArray->Initialize(numRow, numCol, param->unitLengthWireResistance);        // initialize subArray
+	subArray->Initialize(numRow, numCol, ctx.config.unitLengthWireResistance);        // initialize subArray
 	subArray->CalculateArea();
 	
-	if (param->novelMapping) {
-		if (param->parallelRead) {
-			adderTreeNM->Initialize(numSubArrayRowNM, log2((double)param->levelOutput)+param->numBitInput+1, ceil((double)numSubArrayColNM*(double)numCol/(double)param->numColMuxed));
+	if (ctx.config.novelMapping) {
+		if (ctx.config.parallelRead) {
+			ctx.adderTreeNM->Initialize(numSubArrayRowNM, log2((double)ctx.config.levelOutput)+ctx.config.numBitInput+1, ceil((double)numSubArrayColNM*(double)numCol/(double)ctx.config.numColMuxed));
 		} else {
-			adderTreeNM->Initialize(numSubArrayRowNM, (log2((double)numRow)+param->cellBit-1)+param->numBitInput+1, ceil((double)numSubArrayColNM*(double)numCol/(double)param->numColMuxed));
+			ctx.adderTreeNM->Initialize(numSubArrayRowNM, (log2((double)numRow)+ctx.config.cellBit-1)+ctx.config.numBitInput+1, ceil((double)numSubArrayColNM*(double)numCol/(double)ctx.config.numColMuxed));
 		}
 		
-		bufferInputNM->Initialize(param->numBitInput*numRow, param->clkFreq);
-		if (param->parallelRead) {
-			bufferOutputNM->Initialize((numCol/param->numColMuxed)*(log2((double)param->levelOutput)+param->numBitInput+adderTreeNM->numStage), param->clkFreq);
+		ctx.bufferInputNM->Initialize(ctx.config.numBitInput*numRow, ctx.config.clkFreq);
+		if (ctx.config.parallelRead) {
+			ctx.bufferOutputNM->Initialize((numCol/ctx.config.numColMuxed)*(log2((double)ctx.config.levelOutput)+ctx.config.numBitInput+ctx.adderTreeNM->numStage), ctx.config.clkFreq);
 		} else {
-			bufferOutputNM->Initialize((numCol/param->numColMuxed)*((log2((double)numRow)+param->cellBit-1)+param->numBitInput+adderTreeNM->numStage), param->clkFreq);
+			ctx.bufferOutputNM->Initialize((numCol/ctx.config.numColMuxed)*((log2((double)numRow)+ctx.config.cellBit-1)+ctx.config.numBitInput+ctx.adderTreeNM->numStage), ctx.config.clkFreq);
 		}
 		
-		busInputNM->Initialize(HORIZONTAL, numSubArrayRowNM, numSubArrayColNM, 0, numRow, subArray->height, subArray->width);
-		busOutputNM->Initialize(VERTICAL, numSubArrayRowNM, numSubArrayColNM, 0, numCol, subArray->height, subArray->width);
+		ctx.busInputNM->Initialize(HORIZONTAL, numSubArrayRowNM, numSubArrayColNM, 0, numRow, subArray->height, subArray->width);
+		ctx.busOutputNM->Initialize(VERTICAL, numSubArrayRowNM, numSubArrayColNM, 0, numCol, subArray->height, subArray->width);
 	}
-	if (param->parallelRead) {
-		adderTreeCM->Initialize(numSubArrayRowCM, log2((double)param->levelOutput)+param->numBitInput+1, ceil((double)numSubArrayColCM*(double)numCol/(double)param->numColMuxed));
+	if (ctx.config.parallelRead) {
+		ctx.adderTreeCM->Initialize(numSubArrayRowCM, log2((double)ctx.config.levelOutput)+ctx.config.numBitInput+1, ceil((double)numSubArrayColCM*(double)numCol/(double)ctx.config.numColMuxed));
 	} else {
-		adderTreeCM->Initialize(numSubArrayRowCM, (log2((double)numRow)+param->cellBit-1)+param->numBitInput+1, ceil((double)numSubArrayColCM*(double)numCol/(double)param->numColMuxed));
+		ctx.adderTreeCM->Initialize(numSubArrayRowCM, (log2((double)numRow)+ctx.config.cellBit-1)+ctx.config.numBitInput+1, ceil((double)numSubArrayColCM*(double)numCol/(double)ctx.config.numColMuxed));
 	}
 	
-	bufferInputCM->Initialize(param->numBitInput*numRow, param->clkFreq);
-	if (param->parallelRead) {
-		bufferOutputCM->Initialize((numCol/param->numColMuxed)*(log2((double)param->levelOutput)+param->numBitInput+adderTreeCM->numStage), param->clkFreq);
+	ctx.bufferInputCM->Initialize(ctx.config.numBitInput*numRow, ctx.config.clkFreq);
+	if (ctx.config.parallelRead) {
+		ctx.bufferOutputCM->Initialize((numCol/ctx.config.numColMuxed)*(log2((double)ctx.config.levelOutput)+ctx.config.numBitInput+ctx.adderTreeCM->numStage), ctx.config.clkFreq);
 	} else {
-		bufferOutputCM->Initialize((numCol/param->numColMuxed)*((log2((double)numRow)+param->cellBit-1)+param->numBitInput+adderTreeCM->numStage), param->clkFreq);
+		ctx.bufferOutputCM->Initialize((numCol/ctx.config.numColMuxed)*((log2((double)numRow)+ctx.config.cellBit-1)+ctx.config.numBitInput+ctx.adderTreeCM->numStage), ctx.config.clkFreq);
 	}
 	
-	busInputCM->Initialize(HORIZONTAL, numSubArrayRowCM, numSubArrayColCM, 0, numRow, subArray->height, subArray->width);
-	busOutputCM->Initialize(VERTICAL, numSubArrayRowCM, numSubArrayColCM, 0, numCol, subArray->height, subArray->width);
+	ctx.busInputCM->Initialize(HORIZONTAL, numSubArrayRowCM, numSubArrayColCM, 0, numRow, subArray->height, subArray->width);
+	ctx.busOutputCM->Initialize(VERTICAL, numSubArrayRowCM, numSubArrayColCM, 0, numCol, subArray->height, subArray->width);
 }
 
 
-vector<double> ProcessingUnitCalculateArea(SubArray *subArray, int numSubArrayRow, int numSubArrayCol, bool NMpe, double *height, double *width, double *bufferArea) {
+vector<double> ProcessingUnitCalculateArea(SimulationContext& ctx, SubArray *subArray, int numSubArrayRow, int numSubArrayCol, bool NMpe, double *height, double *width, double *bufferArea) {
 	vector<double> areaResults;
 	*height = 0;
 	*width = 0;
@@ -227,38 +323,38 @@ vector<double> ProcessingUnitCalculateArea(SubArray *subArray, int numSubArrayRo
 	
 	subArray->CalculateArea();
 	if (NMpe) {
-		adderTreeNM->CalculateArea(NULL, subArray->width, NONE);
-		bufferInputNM->CalculateArea(numSubArrayRow*subArray->height, NULL, NONE);
-		bufferOutputNM->CalculateArea(NULL, numSubArrayCol*subArray->width, NONE);
+		ctx.adderTreeNM->CalculateArea(NULL, subArray->width, NONE);
+		ctx.bufferInputNM->CalculateArea(numSubArrayRow*subArray->height, NULL, NONE);
+		ctx.bufferOutputNM->CalculateArea(NULL, numSubArrayCol*subArray->width, NONE);
 		
-		busInputNM->CalculateArea(1, true); 
-		busOutputNM->CalculateArea(1, true);	
-		area += subArray->usedArea * (numSubArrayRow*numSubArrayCol) + adderTreeNM->area + bufferInputNM->area + bufferOutputNM->area;
+		ctx.busInputNM->CalculateArea(1, true); 
+		ctx.busOutputNM->CalculateArea(1, true);	
+		area += subArray->usedArea * (numSubArrayRow*numSubArrayCol) + ctx.adderTreeNM->area + ctx.bufferInputNM->area + ctx.bufferOutputNM->area;
 		
 		*height = sqrt(area);
 		*width = area/(*height);
 		
 		areaResults.push_back(area);
 		areaResults.push_back(subArray->areaADC*(numSubArrayRow*numSubArrayCol));
-		areaResults.push_back(subArray->areaAccum*(numSubArrayRow*numSubArrayCol)+adderTreeNM->area);
-		areaResults.push_back(subArray->areaOther*(numSubArrayRow*numSubArrayCol)+ bufferInputNM->area + bufferOutputNM->area);
+		areaResults.push_back(subArray->areaAccum*(numSubArrayRow*numSubArrayCol)+ctx.adderTreeNM->area);
+		areaResults.push_back(subArray->areaOther*(numSubArrayRow*numSubArrayCol)+ ctx.bufferInputNM->area + ctx.bufferOutputNM->area);
 		areaResults.push_back(subArray->areaArray*(numSubArrayRow*numSubArrayCol));
 	} else {
-		adderTreeCM->CalculateArea(NULL, subArray->width, NONE);
-		bufferInputCM->CalculateArea(numSubArrayRow*subArray->height, NULL, NONE);
-		bufferOutputCM->CalculateArea(NULL, numSubArrayCol*subArray->width, NONE);
+		ctx.adderTreeCM->CalculateArea(NULL, subArray->width, NONE);
+		ctx.bufferInputCM->CalculateArea(numSubArrayRow*subArray->height, NULL, NONE);
+		ctx.bufferOutputCM->CalculateArea(NULL, numSubArrayCol*subArray->width, NONE);
 		
-		busInputCM->CalculateArea(1, true); 
-		busOutputCM->CalculateArea(1, true);	
-		area += subArray->usedArea * (numSubArrayRow*numSubArrayCol) + adderTreeCM->area + bufferInputCM->area + bufferOutputCM->area;
+		ctx.busInputCM->CalculateArea(1, true); 
+		ctx.busOutputCM->CalculateArea(1, true);	
+		area += subArray->usedArea * (numSubArrayRow*numSubArrayCol) + ctx.adderTreeCM->area + ctx.bufferInputCM->area + ctx.bufferOutputCM->area;
 		
 		*height = sqrt(area);
 		*width = area/(*height);
 		
 		areaResults.push_back(area);
 		areaResults.push_back(subArray->areaADC*(numSubArrayRow*numSubArrayCol));
-		areaResults.push_back(subArray->areaAccum*(numSubArrayRow*numSubArrayCol)+adderTreeCM->area);
-		areaResults.push_back(subArray->areaOther*(numSubArrayRow*numSubArrayCol)+ bufferInputCM->area + bufferOutputCM->area);
+		areaResults.push_back(subArray->areaAccum*(numSubArrayRow*numSubArrayCol)+ctx.adderTreeCM->area);
+		areaResults.push_back(subArray->areaOther*(numSubArrayRow*numSubArrayCol)+ ctx.bufferInputCM->area + ctx.bufferOutputCM->area);
 		areaResults.push_back(subArray->areaArray*(numSubArrayRow*numSubArrayCol));
 	}
 	
@@ -266,8 +362,8 @@ vector<double> ProcessingUnitCalculateArea(SubArray *subArray, int numSubArrayRo
 }
 
 
-double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vector<double> > &newMemory, const vector<vector<double> > &oldMemory, 
-											const vector<vector<double> > &inputVector,
+void ProcessingUnitCalculatePerformance(SimulationContext& ctx, SubArray *subArray, const LevelMatrixView &newMemory, const LevelMatrixView &oldMemory, 
+											const MatrixView &inputVector,
 											int arrayDupRow, int arrayDupCol, int numSubArrayRow, int numSubArrayCol, int weightMatrixRow,
 											int weightMatrixCol, int numInVector, MemCell& cell, bool NMpe, double *readLatency, double *readDynamicEnergy, double *leakage, 
 											double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
@@ -290,82 +386,54 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 	*coreLatencyOther = 0;
 	
 	double subArrayReadLatency, subArrayReadDynamicEnergy, subArrayLeakage, subArrayLatencyADC, subArrayLatencyAccum, subArrayLatencyOther;
+	double subArrayEnergyADC, subArrayEnergyAccum, subArrayEnergyOther;
 
 	if (arrayDupRow*arrayDupCol > 1) {
 		// weight matrix is duplicated among subArray
 		if (arrayDupRow < numSubArrayRow || arrayDupCol < numSubArrayCol) {
 			// a couple of subArrays are mapped by the matrix
 			// need to redefine the data-grab start-point
-			for (int i=0; i<ceil((double) weightMatrixRow/(double) param->numRowSubArray); i++) {
-				for (int j=0; j<ceil((double) weightMatrixCol/(double) param->numColSubArray); j++) {
-					int numRowMatrix = min(param->numRowSubArray, weightMatrixRow-i*param->numRowSubArray);
-					int numColMatrix = min(param->numColSubArray, weightMatrixCol-j*param->numColSubArray);
+			vector<SubArrayJob> job;
+			for (int i=0; i<ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray); i++) {
+				for (int j=0; j<ceil((double) weightMatrixCol/(double) ctx.config.numColSubArray); j++) {
+					int numRowMatrix = min(ctx.config.numRowSubArray, weightMatrixRow-i*ctx.config.numRowSubArray);
+					int numColMatrix = min(ctx.config.numColSubArray, weightMatrixCol-j*ctx.config.numColSubArray);
 					
-					if ((i*param->numRowSubArray < weightMatrixRow) && (j*param->numColSubArray < weightMatrixCol) && (i*param->numRowSubArray < weightMatrixRow) ) {
+					if ((i*ctx.config.numRowSubArray < weightMatrixRow) && (j*ctx.config.numColSubArray < weightMatrixCol) && (i*ctx.config.numRowSubArray < weightMatrixRow) ) {
 						// assign weight and input to specific subArray
-						vector<vector<double> > subArrayMemory;
-						subArrayMemory = CopySubArray(newMemory, i*param->numRowSubArray, j*param->numColSubArray, numRowMatrix, numColMatrix);
-						vector<vector<double> > subArrayInput;
-						subArrayInput = CopySubInput(inputVector, i*param->numRowSubArray, numInVector, numRowMatrix);
-						
-						subArrayReadLatency = 0;
-						subArrayLatencyADC = 0;
-						subArrayLatencyAccum = 0;
-						subArrayLatencyOther = 0;
-
-						for (int k=0; k<numInVector; k++) {                 // calculate single subArray through the total input vectors
-							double activityRowRead = 0;
-							vector<double> input; 
-							input = GetInputVector(subArrayInput, k, &activityRowRead);
-							subArray->activityRowRead = activityRowRead;
-							
-							int cellRange = pow(2, param->cellBit);
-							if (param->parallelRead) {
-								subArray->levelOutput = param->levelOutput;               // # of levels of the multilevelSenseAmp output
-							} else {
-								subArray->levelOutput = cellRange;
-							}
-							
-							vector<double> columnResistance;
-							columnResistance = GetColumnResistance(input, subArrayMemory, cell, param->parallelRead, subArray->resCellAccess);
-							
-							subArray->CalculateLatency(1e20, columnResistance);
-							subArray->CalculatePower(columnResistance);
-							
-							subArrayReadLatency += subArray->readLatency;
-							*readDynamicEnergy += subArray->readDynamicEnergy;
-							subArrayLeakage = subArray->leakage;
-
-							subArrayLatencyADC += subArray->readLatencyADC;
-							subArrayLatencyAccum += subArray->readLatencyAccum;
-							subArrayLatencyOther += subArray->readLatencyOther;
-							
-							*coreEnergyADC += subArray->readDynamicEnergyADC;
-							*coreEnergyAccum += subArray->readDynamicEnergyAccum;
-							*coreEnergyOther += subArray->readDynamicEnergyOther;
-						}
-						if (NMpe) {
-							adderTreeNM->CalculateLatency((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray), 0);
-							adderTreeNM->CalculatePower((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray));
-							*readLatency = MAX(subArrayReadLatency + adderTreeNM->readLatency, (*readLatency));
-							*readDynamicEnergy += adderTreeNM->readDynamicEnergy;
-							*coreLatencyADC = MAX(subArrayLatencyADC, (*coreLatencyADC));
-							*coreLatencyAccum = MAX(subArrayLatencyAccum + adderTreeNM->readLatency, (*coreLatencyAccum));
-							*coreLatencyOther = MAX(subArrayLatencyOther, (*coreLatencyOther));
-							*coreEnergyAccum += adderTreeNM->readDynamicEnergy;
-						} else {
-							adderTreeCM->CalculateLatency((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray), 0);
-							adderTreeCM->CalculatePower((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray));
-							*readLatency = MAX(subArrayReadLatency + adderTreeCM->readLatency, (*readLatency));
-							*readDynamicEnergy += adderTreeCM->readDynamicEnergy;
-							*coreLatencyADC = MAX(subArrayLatencyADC, (*coreLatencyADC));
-							*coreLatencyAccum = MAX(subArrayLatencyAccum + adderTreeCM->readLatency, (*coreLatencyAccum));
-							*coreLatencyOther = MAX(subArrayLatencyOther, (*coreLatencyOther));
-							*coreEnergyAccum += adderTreeCM->readDynamicEnergy;
-						}
+						job.push_back(SubArrayJob(newMemory.Sub(i*ctx.config.numRowSubArray, j*ctx.config.numColSubArray, numRowMatrix, numColMatrix), 
+												inputVector.Sub(i*ctx.config.numRowSubArray, 0, numRowMatrix, numInVector)));
 					}
 				}
 			}
+			EstimateSubArrays(ctx, subArray, job, numInVector, cell);
+			for (int k=0; k<job.size(); k++) {
+				SubArrayResult(ctx, job[k], &subArrayReadLatency, &subArrayReadDynamicEnergy, &subArrayLeakage,
+								&subArrayLatencyADC, &subArrayLatencyAccum, &subArrayLatencyOther, &subArrayEnergyADC, &subArrayEnergyAccum, &subArrayEnergyOther);
+				*readDynamicEnergy += subArrayReadDynamicEnergy;
+				*coreEnergyADC += subArrayEnergyADC;
+				*coreEnergyAccum += subArrayEnergyAccum;
+				*coreEnergyOther += subArrayEnergyOther;
+				if (NMpe) {
+					ctx.adderTreeNM->CalculateLatency((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray), 0);
+					ctx.adderTreeNM->CalculatePower((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray));
+					*readLatency = MAX(subArrayReadLatency + ctx.adderTreeNM->readLatency, (*readLatency));
+					*readDynamicEnergy += ctx.adderTreeNM->readDynamicEnergy;
+					*coreLatencyADC = MAX(subArrayLatencyADC, (*coreLatencyADC));
+					*coreLatencyAccum = MAX(subArrayLatencyAccum + ctx.adderTreeNM->readLatency, (*coreLatencyAccum));
+					*coreLatencyOther = MAX(subArrayLatencyOther, (*coreLatencyOther));
+					*coreEnergyAccum += ctx.adderTreeNM->readDynamicEnergy;
+				} else {
+					ctx.adderTreeCM->CalculateLatency((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray), 0);
+					ctx.adderTreeCM->CalculatePower((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray));
+					*readLatency = MAX(subArrayReadLatency + ctx.adderTreeCM->readLatency, (*readLatency));
+					*readDynamicEnergy += ctx.adderTreeCM->readDynamicEnergy;
+					*coreLatencyADC = MAX(subArrayLatencyADC, (*coreLatencyADC));
+					*coreLatencyAccum = MAX(subArrayLatencyAccum + ctx.adderTreeCM->readLatency, (*coreLatencyAccum));
+					*coreLatencyOther = MAX(subArrayLatencyOther, (*coreLatencyOther));
+					*coreEnergyAccum += ctx.adderTreeCM->readDynamicEnergy;
+				}
+			}
 			// considering speedup, the latency of processing each layer is decreased
 			*readLatency = (*readLatency)/(arrayDupRow*arrayDupCol);
 			*coreLatencyADC = (*coreLatencyADC)/(arrayDupRow*arrayDupCol);
@@ -373,47 +441,16 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 			*coreLatencyOther = (*coreLatencyOther)/(arrayDupRow*arrayDupCol);
 		} else {
 			// assign weight and input to specific subArray
-			vector<vector<double> > subArrayMemory;
-			subArrayMemory = CopySubArray(newMemory, 0, 0, weightMatrixRow, weightMatrixCol);
-			vector<vector<double> > subArrayInput;
-			subArrayInput = CopySubInput(inputVector, 0, numInVector, weightMatrixRow);
-
-			subArrayReadLatency = 0;
-			subArrayLatencyADC = 0;
-			subArrayLatencyAccum = 0;
-			subArrayLatencyOther = 0;
-
-			for (int k=0; k<numInVector; k++) {                 // calculate single subArray through the total input vectors
-				double activityRowRead = 0;
-				vector<double> input;
-				input = GetInputVector(subArrayInput, k, &activityRowRead);
-				subArray->activityRowRead = activityRowRead;
-				int cellRange = pow(2, param->cellBit);
-				
-				if (param->parallelRead) {
-					subArray->levelOutput = param->levelOutput;               // # of levels of the multilevelSenseAmp output
-				} else {
-					subArray->levelOutput = cellRange;
-				}
-				
-				vector<double> columnResistance;
-				columnResistance = GetColumnResistance(input, subArrayMemory, cell, param->parallelRead, subArray->resCellAccess);
-				
-				subArray->CalculateLatency(1e20, columnResistance);
-				subArray->CalculatePower(columnResistance);
-				
-				subArrayReadLatency += subArray->readLatency;
-				*readDynamicEnergy += subArray->readDynamicEnergy;
-				subArrayLeakage = subArray->leakage;
-				
-				subArrayLatencyADC += subArray->readLatencyADC;
-				subArrayLatencyAccum += subArray->readLatencyAccum;
-				subArrayLatencyOther += subArray->readLatencyOther;
-				
-				*coreEnergyADC += subArray->readDynamicEnergyADC;
-				*coreEnergyAccum += subArray->readDynamicEnergyAccum;
-				*coreEnergyOther += subArray->readDynamicEnergyOther;
-			}
+			LevelMatrixView subArrayMemory;
+			subArrayMemory = newMemory.Sub(0, 0, weightMatrixRow, weightMatrixCol);
+			MatrixView subArrayInput;
+			subArrayInput = inputVector.Sub(0, 0, weightMatrixRow, numInVector);
+			SubArrayCalculatePerformance(ctx, subArray, subArrayMemory, subArrayInput, numInVector, cell, &subArrayReadLatency, &subArrayReadDynamicEnergy, &subArrayLeakage,
+										&subArrayLatencyADC, &subArrayLatencyAccum, &subArrayLatencyOther, &subArrayEnergyADC, &subArrayEnergyAccum, &subArrayEnergyOther);
+			*readDynamicEnergy += subArrayReadDynamicEnergy;
+			*coreEnergyADC += subArrayEnergyADC;
+			*coreEnergyAccum += subArrayEnergyAccum;
+			*coreEnergyOther += subArrayEnergyOther;
 			
 			// do not pass adderTree 
 			*readLatency = subArrayReadLatency/(arrayDupRow*arrayDupCol);
@@ -423,125 +460,95 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 		}
 	} else {
 		// weight matrix is further partitioned inside PE (among subArray) --> no duplicated
-		for (int i=0; i<numSubArrayRow/*ceil((double) weightMatrixRow/(double) param->numRowSubArray)*/; i++) {
-			for (int j=0; j<numSubArrayCol/*ceil((double) weightMatrixCol/(double) param->numColSubArray)*/; j++) {
-				if ((i*param->numRowSubArray < weightMatrixRow) && (j*param->numColSubArray < weightMatrixCol) && (i*param->numRowSubArray < weightMatrixRow) ) {
-					int numRowMatrix = min(param->numRowSubArray, weightMatrixRow-i*param->numRowSubArray);
-					int numColMatrix = min(param->numColSubArray, weightMatrixCol-j*param->numColSubArray);
+		vector<SubArrayJob> job;
+		for (int i=0; i<numSubArrayRow/*ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray)*/; i++) {
+			for (int j=0; j<numSubArrayCol/*ceil((double) weightMatrixCol/(double) ctx.config.numColSubArray)*/; j++) {
+				if ((i*ctx.config.numRowSubArray < weightMatrixRow) && (j*ctx.config.numColSubArray < weightMatrixCol) && (i*ctx.config.numRowSubArray < weightMatrixRow) ) {
+					int numRowMatrix = min(ctx.config.numRowSubArray, weightMatrixRow-i*ctx.config.numRowSubArray);
+					int numColMatrix = min(ctx.config.numColSubArray, weightMatrixCol-j*ctx.config.numColSubArray);
 					// assign weight and input to specific subArray
-					vector<vector<double> > subArrayMemory;
-					subArrayMemory = CopySubArray(newMemory, i*param->numRowSubArray, j*param->numColSubArray, numRowMatrix, numColMatrix);
-					vector<vector<double> > subArrayInput;
-					subArrayInput = CopySubInput(inputVector, i*param->numRowSubArray, numInVector, numRowMatrix);
-					
-					subArrayReadLatency = 0;
-					subArrayLatencyADC = 0;
-					subArrayLatencyAccum = 0;
-					subArrayLatencyOther = 0;
-					
-					for (int k=0; k<numInVector; k++) {                 // calculate single subArray through the total input vectors
-						double activityRowRead = 0;
-						vector<double> input;
-						input = GetInputVector(subArrayInput, k, &activityRowRead);
-						subArray->activityRowRead = activityRowRead;
-						
-						int cellRange = pow(2, param->cellBit);
-						if (param->parallelRead) {
-							subArray->levelOutput = param->levelOutput;               // # of levels of the multilevelSenseAmp output
-						} else {
-							subArray->levelOutput = cellRange;
-						}
-						
-						vector<double> columnResistance;
-						columnResistance = GetColumnResistance(input, subArrayMemory, cell, param->parallelRead, subArray->resCellAccess);
-
-						subArray->CalculateLatency(1e20, columnResistance);
-						subArray->CalculatePower(columnResistance);
-						
-						subArrayReadLatency += subArray->readLatency;
-						*readDynamicEnergy += subArray->readDynamicEnergy;
-						subArrayLeakage = subArray->leakage;
-						
-						subArrayLatencyADC += subArray->readLatencyADC;
-						subArrayLatencyAccum += subArray->readLatencyAccum;
-						subArrayLatencyOther += subArray->readLatencyOther;
-						
-						*coreEnergyADC += subArray->readDynamicEnergyADC;
-						*coreEnergyAccum += subArray->readDynamicEnergyAccum;
-						*coreEnergyOther += subArray->readDynamicEnergyOther;
-						
-					}
-					*readLatency = MAX(subArrayReadLatency, (*readLatency));
-					*coreLatencyADC = MAX(subArrayLatencyADC, (*coreLatencyADC));
-					*coreLatencyAccum = MAX(subArrayLatencyAccum, (*coreLatencyAccum));
-					*coreLatencyOther = MAX(subArrayLatencyOther, (*coreLatencyOther));
+					job.push_back(SubArrayJob(newMemory.Sub(i*ctx.config.numRowSubArray, j*ctx.config.numColSubArray, numRowMatrix, numColMatrix), 
+											inputVector.Sub(i*ctx.config.numRowSubArray, 0, numRowMatrix, numInVector)));
 				}
 			}
 		}
+		EstimateSubArrays(ctx, subArray, job, numInVector, cell);
+		for (int k=0; k<job.size(); k++) {
+			SubArrayResult(ctx, job[k], &subArrayReadLatency, &subArrayReadDynamicEnergy, &subArrayLeakage,
+							&subArrayLatencyADC, &subArrayLatencyAccum, &subArrayLatencyOther, &subArrayEnergyADC, &subArrayEnergyAccum, &subArrayEnergyOther);
+			*readDynamicEnergy += subArrayReadDynamicEnergy;
+			*coreEnergyADC += subArrayEnergyADC;
+			*coreEnergyAccum += subArrayEnergyAccum;
+			*coreEnergyOther += subArrayEnergyOther;
+			*readLatency = MAX(subArrayReadLatency, (*readLatency));
+			*coreLatencyADC = MAX(subArrayLatencyADC, (*coreLatencyADC));
+			*coreLatencyAccum = MAX(subArrayLatencyAccum, (*coreLatencyAccum));
+			*coreLatencyOther = MAX(subArrayLatencyOther, (*coreLatencyOther));
+		}
 		if (NMpe) {
-			adderTreeNM->CalculateLatency((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray), 0);
-			adderTreeNM->CalculatePower((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray));
-			*readLatency += adderTreeNM->readLatency;
-			*coreLatencyAccum += adderTreeNM->readLatency;
-			*readDynamicEnergy += adderTreeNM->readDynamicEnergy;
-			*coreEnergyAccum += adderTreeNM->readDynamicEnergy;
+			ctx.adderTreeNM->CalculateLatency((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray), 0);
+			ctx.adderTreeNM->CalculatePower((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray));
+			*readLatency += ctx.adderTreeNM->readLatency;
+			*coreLatencyAccum += ctx.adderTreeNM->readLatency;
+			*readDynamicEnergy += ctx.adderTreeNM->readDynamicEnergy;
+			*coreEnergyAccum += ctx.adderTreeNM->readDynamicEnergy;
 		} else {
-			adderTreeCM->CalculateLatency((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray), 0);
-			adderTreeCM->CalculatePower((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray));
-			*readLatency += adderTreeCM->readLatency;
-			*coreLatencyAccum += adderTreeCM->readLatency;
-			*readDynamicEnergy += adderTreeCM->readDynamicEnergy;
-			*coreEnergyAccum += adderTreeCM->readDynamicEnergy;
+			ctx.adderTreeCM->CalculateLatency((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray), 0);
+			ctx.adderTreeCM->CalculatePower((int)(numInVector/ctx.config.numBitInput)*ctx.config.numColMuxed, ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray));
+			*readLatency += ctx.adderTreeCM->readLatency;
+			*coreLatencyAccum += ctx.adderTreeCM->readLatency;
+			*readDynamicEnergy += ctx.adderTreeCM->readDynamicEnergy;
+			*coreEnergyAccum += ctx.adderTreeCM->readDynamicEnergy;
 		}
 		
 	}
 	//considering buffer activation: no matter speedup or not, the total number of data transferred is fixed
 	// input buffer: total num of data loaded in = weightMatrixRow*numInVector
-	// output buffer: total num of data transferred = weightMatrixRow*numInVector/param->numBitInput (total num of IFM in the PE) *adderTree->numAdderTree*adderTree->numAdderBit (bit precision of OFMs) 
+	// output buffer: total num of data transferred = weightMatrixRow*numInVector/ctx.config.numBitInput (total num of IFM in the PE) *adderTree->numAdderTree*adderTree->numAdderBit (bit precision of OFMs) 
 	if (NMpe) {
-		bufferInputNM->CalculateLatency(0, numInVector*ceil((double) weightMatrixRow/(double) param->numRowSubArray));
-		bufferOutputNM->CalculateLatency(0, numInVector/param->numBitInput);
-		bufferInputNM->CalculatePower(weightMatrixRow/param->numRowPerSynapse, numInVector);
-		bufferOutputNM->CalculatePower(weightMatrixCol/param->numColPerSynapse*adderTreeNM->numAdderBit, numInVector/param->numBitInput);
+		ctx.bufferInputNM->CalculateLatency(0, numInVector*ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray));
+		ctx.bufferOutputNM->CalculateLatency(0, numInVector/ctx.config.numBitInput);
+		ctx.bufferInputNM->CalculatePower(weightMatrixRow/ctx.config.numRowPerSynapse, numInVector);
+		ctx.bufferOutputNM->CalculatePower(weightMatrixCol/ctx.config.numColPerSynapse*ctx.adderTreeNM->numAdderBit, numInVector/ctx.config.numBitInput);
 		
-		busInputNM->CalculateLatency(weightMatrixRow/param->numRowPerSynapse*numInVector/(busInputNM->busWidth)); 
-		busInputNM->CalculatePower(busInputNM->busWidth, weightMatrixRow/param->numRowPerSynapse*numInVector/(busInputNM->busWidth));
+		ctx.busInputNM->CalculateLatency(weightMatrixRow/ctx.config.numRowPerSynapse*numInVector/(ctx.busInputNM->busWidth)); 
+		ctx.busInputNM->CalculatePower(ctx.busInputNM->busWidth, weightMatrixRow/ctx.config.numRowPerSynapse*numInVector/(ctx.busInputNM->busWidth));
 		
-		if (param->parallelRead) {
-			busOutputNM->CalculateLatency((weightMatrixCol/param->numColPerSynapse*log2((double)param->levelOutput)*numInVector/param->numBitInput)/(busOutputNM->numRow*busOutputNM->busWidth));
-			busOutputNM->CalculatePower(busOutputNM->numRow*busOutputNM->busWidth, (weightMatrixCol/param->numColPerSynapse*log2((double)param->levelOutput)*numInVector/param->numBitInput)/(busOutputNM->numRow*busOutputNM->busWidth));
+		if (ctx.config.parallelRead) {
+			ctx.busOutputNM->CalculateLatency((weightMatrixCol/ctx.config.numColPerSynapse*log2((double)ctx.config.levelOutput)*numInVector/ctx.config.numBitInput)/(ctx.busOutputNM->numRow*ctx.busOutputNM->busWidth));
+			ctx.busOutputNM->CalculatePower(ctx.busOutputNM->numRow*ctx.busOutputNM->busWidth, (weightMatrixCol/ctx.config.numColPerSynapse*log2((double)ctx.config.levelOutput)*numInVector/ctx.config.numBitInput)/(ctx.busOutputNM->numRow*ctx.busOutputNM->busWidth));
 		} else {
-			busOutputNM->CalculateLatency((weightMatrixCol/param->numColPerSynapse*(log2((double)param->numRowSubArray)+param->cellBit-1)*numInVector/param->numBitInput)/(busOutputNM->numRow*busOutputNM->busWidth));
-			busOutputNM->CalculatePower(busOutputNM->numRow*busOutputNM->busWidth, (weightMatrixCol/param->numColPerSynapse*(log2((double)param->numRowSubArray)+param->cellBit-1)*numInVector/param->numBitInput)/(busOutputNM->numRow*busOutputNM->busWidth));
+			ctx.busOutputNM->CalculateLatency((weightMatrixCol/ctx.config.numColPerSynapse*(log2((double)ctx.config.numRowSubArray)+ctx.config.cellBit-1)*numInVector/ctx.config.numBitInput)/(ctx.busOutputNM->numRow*ctx.busOutputNM->busWidth));
+			ctx.busOutputNM->CalculatePower(ctx.busOutputNM->numRow*ctx.busOutputNM->busWidth, (weightMatrixCol/ctx.config.numColPerSynapse*(log2((double)ctx.config.numRowSubArray)+ctx.config.cellBit-1)*numInVector/ctx.config.numBitInput)/(ctx.busOutputNM->numRow*ctx.busOutputNM->busWidth));
 		}
 
-		*bufferLatency = bufferInputNM->readLatency + bufferOutputNM->readLatency;
-		*icLatency = busInputNM->readLatency + busOutputNM->readLatency;
-		*bufferDynamicEnergy += bufferInputNM->readDynamicEnergy + bufferOutputNM->readDynamicEnergy;
-		*icDynamicEnergy += busInputNM->readDynamicEnergy + busOutputNM->readDynamicEnergy;
-		*leakage = subArrayLeakage*numSubArrayRow*numSubArrayCol + adderTreeNM->leakage + bufferInputNM->leakage + bufferOutputNM->leakage;
+		*bufferLatency = ctx.bufferInputNM->readLatency + ctx.bufferOutputNM->readLatency;
+		*icLatency = ctx.busInputNM->readLatency + ctx.busOutputNM->readLatency;
+		*bufferDynamicEnergy += ctx.bufferInputNM->readDynamicEnergy + ctx.bufferOutputNM->readDynamicEnergy;
+		*icDynamicEnergy += ctx.busInputNM->readDynamicEnergy + ctx.busOutputNM->readDynamicEnergy;
+		*leakage = subArrayLeakage*numSubArrayRow*numSubArrayCol + ctx.adderTreeNM->leakage + ctx.bufferInputNM->leakage + ctx.bufferOutputNM->leakage;
 	} else {
-		bufferInputCM->CalculateLatency(0, numInVector*ceil((double) weightMatrixRow/(double) param->numRowSubArray));
-		bufferOutputCM->CalculateLatency(0, numInVector/param->numBitInput);
-		bufferInputCM->CalculatePower(weightMatrixRow/param->numRowPerSynapse, numInVector);
-		bufferOutputCM->CalculatePower(weightMatrixCol/param->numColPerSynapse*adderTreeCM->numAdderBit, numInVector/param->numBitInput);
+		ctx.bufferInputCM->CalculateLatency(0, numInVector*ceil((double) weightMatrixRow/(double) ctx.config.numRowSubArray));
+		ctx.bufferOutputCM->CalculateLatency(0, numInVector/ctx.config.numBitInput);
+		ctx.bufferInputCM->CalculatePower(weightMatrixRow/ctx.config.numRowPerSynapse, numInVector);
+		ctx.bufferOutputCM->CalculatePower(weightMatrixCol/ctx.config.numColPerSynapse*ctx.adderTreeCM->numAdderBit, numInVector/ctx.config.numBitInput);
 		
-		busInputCM->CalculateLatency(weightMatrixRow/param->numRowPerSynapse*numInVector/(busInputCM->busWidth)); 
-		busInputCM->CalculatePower(busInputCM->busWidth, weightMatrixRow/param->numRowPerSynapse*numInVector/(busInputCM->busWidth));
+		ctx.busInputCM->CalculateLatency(weightMatrixRow/ctx.config.numRowPerSynapse*numInVector/(ctx.busInputCM->busWidth)); 
+		ctx.busInputCM->CalculatePower(ctx.busInputCM->busWidth, weightMatrixRow/ctx.config.numRowPerSynapse*numInVector/(ctx.busInputCM->busWidth));
 		
-		if (param->parallelRead) {
-			busOutputCM->CalculateLatency((weightMatrixCol/param->numColPerSynapse*log2((double)param->levelOutput)*numInVector/param->numBitInput)/(busOutputCM->numRow*busOutputCM->busWidth));
-			busOutputCM->CalculatePower(busOutputCM->numRow*busOutputCM->busWidth, (weightMatrixCol/param->numColPerSynapse*log2((double)param->levelOutput)*numInVector/param->numBitInput)/(busOutputCM->numRow*busOutputCM->busWidth));
+		if (ctx.config.parallelRead) {
+			ctx.busOutputCM->CalculateLatency((weightMatrixCol/ctx.config.numColPerSynapse*log2((double)ctx.config.levelOutput)*numInVector/ctx.config.numBitInput)/(ctx.busOutputCM->numRow*ctx.busOutputCM->busWidth));
+			ctx.busOutputCM->CalculatePower(ctx.busOutputCM->numRow*ctx.busOutputCM->busWidth, (weightMatrixCol/ctx.config.numColPerSynapse*log2((double)ctx.config.levelOutput)*numInVector/ctx.config.numBitInput)/(ctx.busOutputCM->numRow*ctx.busOutputCM->busWidth));
 		} else {
-			busOutputCM->CalculateLatency((weightMatrixCol/param->numColPerSynapse*(log2((double)param->numRowSubArray)+param->cellBit-1)*numInVector/param->numBitInput)/(busOutputCM->numRow*busOutputCM->busWidth));
-			busOutputCM->CalculatePower(busOutputCM->numRow*busOutputCM->busWidth, (weightMatrixCol/param->numColPerSynapse*(log2((double)param->numRowSubArray)+param->cellBit-1)*numInVector/param->numBitInput)/(busOutputCM->numRow*busOutputCM->busWidth));
+			ctx.busOutputCM->CalculateLatency((weightMatrixCol/ctx.config.numColPerSynapse*(log2((double)ctx.config.numRowSubArray)+ctx.config.cellBit-1)*numInVector/ctx.config.numBitInput)/(ctx.busOutputCM->numRow*ctx.busOutputCM->busWidth));
+			ctx.busOutputCM->CalculatePower(ctx.busOutputCM->numRow*ctx.busOutputCM->busWidth, (weightMatrixCol/ctx.config.numColPerSynapse*(log2((double)ctx.config.numRowSubArray)+ctx.config.cellBit-1)*numInVector/ctx.config.numBitInput)/(ctx.busOutputCM->numRow*ctx.busOutputCM->busWidth));
 		}
 
-		*bufferLatency = bufferInputCM->readLatency + bufferOutputCM->readLatency;
-		*icLatency = busInputCM->readLatency + busOutputCM->readLatency;
-		*bufferDynamicEnergy += bufferInputCM->readDynamicEnergy + bufferOutputCM->readDynamicEnergy;
-		*icDynamicEnergy += busInputCM->readDynamicEnergy + busOutputCM->readDynamicEnergy;
-		*leakage = subArrayLeakage*numSubArrayRow*numSubArrayCol + adderTreeCM->leakage + bufferInputCM->leakage + bufferOutputCM->leakage;
+		*bufferLatency = ctx.bufferInputCM->readLatency + ctx.bufferOutputCM->readLatency;
+		*icLatency = ctx.busInputCM->readLatency + ctx.busOutputCM->readLatency;
+		*bufferDynamicEnergy += ctx.bufferInputCM->readDynamicEnergy + ctx.bufferOutputCM->readDynamicEnergy;
+		*icDynamicEnergy += ctx.busInputCM->readDynamicEnergy + ctx.busOutputCM->readDynamicEnergy;
+		*leakage = subArrayLeakage*numSubArrayRow*numSubArrayCol + ctx.adderTreeCM->leakage + ctx.bufferInputCM->leakage + ctx.bufferOutputCM->leakage;
 	}
 	*readLatency += (*bufferLatency) + (*icLatency);
 	*readDynamicEnergy += (*bufferDynamicEnergy) + (*icDynamicEnergy);
@@ -550,123 +557,403 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 }
 
 
-vector<vector<double> > CopySubArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol) {
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numCol; j++) {
-			copyRow.push_back(orginal[positionRow+i][positionCol+j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
-	}
-	return copy;
-	copy.clear();
-} 
+static void EvaluateColumnResistance(SubArray *subArray, double activityRowRead, const vector<double> &columnResistance, vector<double> &cost) {
+	// cost of one input vector: readLatency, readLatencyADC, readLatencyAccum, readLatencyOther, readDynamicEnergy, readDynamicEnergyADC, readDynamicEnergyAccum, readDynamicEnergyOther, leakage
+	subArray->activityRowRead = activityRowRead;
+	subArray->CalculatePerformance(columnResistance);
+	
+	cost.resize(9);
+	cost[0] = subArray->readLatency;
+	cost[1] = subArray->readLatencyADC;
+	cost[2] = subArray->readLatencyAccum;
+	cost[3] = subArray->readLatencyOther;
+	cost[4] = subArray->readDynamicEnergy;
+	cost[5] = subArray->readDynamicEnergyADC;
+	cost[6] = subArray->readDynamicEnergyAccum;
+	cost[7] = subArray->readDynamicEnergyOther;
+	cost[8] = subArray->leakage;
+}
 
 
-vector<vector<double> > CopySubInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow) {
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numInputVector; j++) {
-			copyRow.push_back(orginal[positionRow+i][j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
-	}
-	return copy;
-	copy.clear();
+static void EvaluateInputPattern(SimulationContext& ctx, SubArray *subArray, const vector<uint64_t> &input, double activityRowRead, const vector<double> &subArrayConductance, int numCol, vector<double> &cost) {
+	vector<double> columnResistance;
+	columnResistance = GetColumnResistance(ctx, input, subArrayConductance, numCol);
+	EvaluateColumnResistance(subArray, activityRowRead, columnResistance, cost);
 }
 
 
-vector<double> GetInputVector(const vector<vector<double> > &input, int numInput, double *activityRowRead) {
-	vector<double> copy;
-	for (int i=0; i<input.size(); i++) {
-		double x = input[i][numInput];
-		copy.push_back(x);   
-	}  
-	double numofreadrow = 0;  // initialize readrowactivity parameters
-	for (int i=0; i<input.size(); i++) {
-		if (copy[i] != 0) {
-			numofreadrow += 1;
-		}else {
-			numofreadrow += 0;
+static void SubArrayFastEstimate(SimulationContext& ctx, SubArray *subArray, const MatrixView &subArrayInput, int numInVector, const vector<double> &subArrayConductance, int numCol, vector<double> &estimate) {
+	// analytical estimate (param->fastEstimate): one pass over the packed input vectors (through the nonzero index when the trace has one) builds the row-activity histogram,
+	// i.e. for each bin of # of activated rows (bin 0: none, then param->fastEstimateBins bins): the # of input vectors, their summed # of activated rows and read activity,
+	// and how often each row is activated; the column-conductance histogram is the mean conductance of each column over the activated rows of each bin, each bin is evaluated once
+	int numRow = subArrayInput.numRow;
+	int stride = ColumnKernelStride(numCol);
+	int numActiveBin = MAX(1, MIN(ctx.config.fastEstimateBins, numRow));
+	vector<int> binVector(numActiveBin+1, 0);
+	vector<double> binActivatedRow(numActiveBin+1, 0), binActivity(numActiveBin+1, 0);
+	vector<vector<int> > binRowCount(numActiveBin+1);
+	for (int k=0; k<numInVector; k++) {
+		double activityRowRead = 0;
+		vector<uint64_t> input;
+		input = GetInputVector(subArrayInput, k, &activityRowRead);
+		int activatedRow = 0;
+		for (int w=0; w<input.size(); w++) {
+			activatedRow += __builtin_popcountll(input[w]);
+		}
+		int bin = (activatedRow == 0)? 0 : 1 + (long) (activatedRow-1)*numActiveBin/numRow;
+		binVector[bin]++;
+		binActivatedRow[bin] += activatedRow;
+		binActivity[bin] += activityRowRead;
+		vector<int> &rowCount = binRowCount[bin];
+		if (rowCount.empty()) {
+			rowCount.assign(numRow, 0);
+		}
+		for (int w=0; w<input.size(); w++) {
+			for (uint64_t bits=input[w]; bits; bits&=bits-1) {
+				rowCount[w*64 + __builtin_ctzll(bits)]++;
+			}
 		}
 	}
-	double totalnumRow = input.size();
-	*(activityRowRead) = numofreadrow/totalnumRow;
-	return copy;
-	copy.clear();
-} 
+	
+	estimate.assign(9, 0);
+	for (int bin=0; bin<=numActiveBin; bin++) {
+		if (binVector[bin] == 0) {
+			continue;
+		}
+		vector<double> columnG(stride, 0), columnResistance(numCol), cost;
+		for (int i=0; i<numRow; i++) {
+			if (binRowCount[bin][i] == 0) {
+				continue;
+			}
+			double rowWeight = (double) binRowCount[bin][i]/binVector[bin];
+			const double *conductanceRow = &subArrayConductance[i*stride];
+			for (int j=0; j<numCol; j++) {
+				columnG[j] += rowWeight*conductanceRow[j];
+			}
+		}
+		int activatedRow = (int) (binActivatedRow[bin]/binVector[bin] + 0.5);
+		ctx.columnResistanceKernel(&columnG[0], numCol, activatedRow, &columnResistance[0]);
+		EvaluateColumnResistance(subArray, binActivity[bin]/binVector[bin], columnResistance, cost);
+		for (int m=0; m<8; m++) {
+			estimate[m] += cost[m]*binVector[bin];
+		}
+		estimate[8] = cost[8];
+	}
+}
 
 
-vector<double> GetColumnResistance(const vector<double> &input, const vector<vector<double> > &weight, MemCell& cell, bool parallelRead, double resCellAccess) {
-	vector<double> resistance;
-	vector<double> conductance;
-	double columnG = 0; 
+static void SubArrayEstimate(SimulationContext& ctx, SubArray *subArray, SubArrayJob &job, int numInVector, MemCell& cell, bool splitPatterns) {
+	// calculate single subArray through the total input vectors, each distinct input vector is evaluated once and weighted by its occurrence count
+	// with param->inputSampling, only a stratified random subset of the input vectors is evaluated and the totals are extrapolated
+	const LevelMatrixView &subArrayMemory = job.memory;
+	const MatrixView &subArrayInput = job.input;
+	vector<double> &estimate = job.estimate;
+	vector<double> subArrayConductance;
+	subArrayConductance = GetCellConductance(ctx, subArrayMemory, cell, subArray->resCellAccess);
+	int numCol = subArrayMemory.numCol;
 	
-	for (int j=0; j<weight[0].size(); j++) {
-		int activatedRow = 0;
-		columnG = 0;
-		for (int i=0; i<weight.size(); i++) {
-			if (cell.memCellType == Type::RRAM) {	// eNVM
-				double totalWireResistance;
-				if (cell.accessType == CMOS_access) {
-					totalWireResistance = (double) 1.0/weight[i][j] + (j + 1) * param->wireResistanceRow + (weight.size() - i) * param->wireResistanceCol + cell.resistanceAccess;
-				} else {
-					totalWireResistance = (double) 1.0/weight[i][j] + (j + 1) * param->wireResistanceRow + (weight.size() - i) * param->wireResistanceCol;
-				}
-				if ((int) input[i] == 1) {
-					columnG += (double) 1.0/totalWireResistance;
-					activatedRow += 1 ;
-				} else {
-					columnG += 0;
-				}
-			} else if (cell.memCellType == Type::FeFET) {
-				double totalWireResistance;
-				totalWireResistance = (double) 1.0/weight[i][j] + (j + 1) * param->wireResistanceRow + (weight.size() - i) * param->wireResistanceCol;
-				if ((int) input[i] == 1) {
-					columnG += (double) 1.0/totalWireResistance;
-					activatedRow += 1 ;
-				} else {
-					columnG += 0;
+	int cellRange = pow(2, ctx.config.cellBit);
+	if (ctx.config.parallelRead) {
+		subArray->levelOutput = ctx.config.levelOutput;               // # of levels of the multilevelSenseAmp output
+	} else {
+		subArray->levelOutput = cellRange;
+	}
+	
+	if (ctx.config.fastEstimate) {
+		SubArrayFastEstimate(ctx, subArray, subArrayInput, numInVector, subArrayConductance, numCol, estimate);
+		return;
+	}
+	
+	// group the input vectors by pattern, kept in the order of first appearance
+	unordered_map<vector<uint64_t>, int, InputPatternHash> patternIndex;
+	vector<vector<uint64_t> > pattern;
+	vector<double> patternActivity;
+	vector<int> patternCount;
+	vector<int> vectorPattern(numInVector);
+	uint64_t seed = 0;
+	for (int k=0; k<numInVector; k++) {
+		double activityRowRead = 0;
+		vector<uint64_t> input;
+		input = GetInputVector(subArrayInput, k, &activityRowRead);
+		uint64_t activityBits;
+		memcpy(&activityBits, &activityRowRead, sizeof(activityBits));
+		input.push_back(activityBits);
+		
+		unordered_map<vector<uint64_t>, int, InputPatternHash>::iterator it = patternIndex.find(input);
+		if (it == patternIndex.end()) {
+			vectorPattern[k] = pattern.size();
+			patternIndex[input] = pattern.size();
+			input.pop_back();
+			pattern.push_back(input);
+			patternActivity.push_back(activityRowRead);
+			patternCount.push_back(1);
+		} else {
+			vectorPattern[k] = it->second;
+			patternCount[it->second]++;
+		}
+		seed = seed*1099511628211ULL + vectorPattern[k];
+	}
+	job.numInputVectorTotal += numInVector;
+	
+	vector<vector<double> > patternCost(pattern.size());
+	vector<double> variance(9, 0);
+	estimate.assign(9, 0);
+	if (!ctx.config.inputSampling || numInVector <= ctx.config.inputSampleSize) {
+		// the patterns are independent: a subArray evaluated alone (splitPatterns) shares them out to one task per thread of the team, each on its own copy of subArray
+		int numTask = splitPatterns? MIN(pattern.size(), omp_get_num_threads()) : 1;
+		SimulationContext *context = &ctx;
+		#pragma omp taskloop if(numTask > 1) grainsize(1) shared(pattern, patternActivity, subArrayConductance, patternCost)
+		for (int t=0; t<numTask; t++) {
+			ParamBinding binding(*context);
+			SubArray *taskSubArray = (numTask > 1)? new SubArray(*subArray) : subArray;
+			for (int p=t; p<pattern.size(); p+=numTask) {
+				EvaluateInputPattern(*context, taskSubArray, pattern[p], patternActivity[p], subArrayConductance, numCol, patternCost[p]);
+			}
+			if (taskSubArray != subArray) {
+				delete taskSubArray;
+			}
+		}
+		for (int p=0; p<pattern.size(); p++) {
+			for (int m=0; m<8; m++) {
+				estimate[m] += patternCost[p][m]*patternCount[p];
+			}
+			estimate[8] = patternCost[p][8];
+		}
+		job.numInputVectorSimulated += numInVector;
+		job.numInputPattern += pattern.size();
+	} else {
+		// stratify the input vectors by activityRowRead, the random order of each stratum only depends on the input trace of this subArray
+		map<double, vector<int> > stratum;
+		for (int k=0; k<numInVector; k++) {
+			stratum[patternActivity[vectorPattern[k]]].push_back(k);
+		}
+		mt19937_64 generator(seed);
+		for (map<double, vector<int> >::iterator it=stratum.begin(); it!=stratum.end(); it++) {
+			shuffle(it->second.begin(), it->second.end(), generator);
+		}
+		
+		// proportional allocation with at least 2 samples per stratum (so more than inputSampleSize when there are over inputSampleSize/2 strata), 
+		// doubled until the target error is met
+		int sampleSize = ctx.config.inputSampleSize;
+		int numSample;
+		while (true) {
+			numSample = 0;
+			estimate.assign(9, 0);
+			variance.assign(9, 0);
+			for (map<double, vector<int> >::iterator it=stratum.begin(); it!=stratum.end(); it++) {
+				double N = it->second.size();
+				int n = MIN(N, MAX(2, ceil((double) sampleSize*N/numInVector)));
+				vector<double> sum(8, 0), sumSquare(8, 0);
+				for (int s=0; s<n; s++) {
+					int p = vectorPattern[it->second[s]];
+					if (patternCost[p].empty()) {
+						EvaluateInputPattern(ctx, subArray, pattern[p], patternActivity[p], subArrayConductance, numCol, patternCost[p]);
+						job.numInputPattern += 1;
+					}
+					for (int m=0; m<8; m++) {
+						sum[m] += patternCost[p][m];
+						sumSquare[m] += patternCost[p][m]*patternCost[p][m];
+					}
+					estimate[8] = patternCost[p][8];
 				}
-				
-			} else if (cell.memCellType == Type::SRAM) {	
-				// SRAM: weight value do not affect sense energy --> read energy calculated in subArray.cpp (based on wireRes wireCap etc)
-				double totalWireResistance = (double) (resCellAccess + param->wireResistanceCol);
-				if ((int) input[i] == 1) {
-					columnG += (double) 1.0/totalWireResistance;
-					activatedRow += 1 ;
-				} else {
-					columnG += 0;
+				for (int m=0; m<8; m++) {
+					double mean = sum[m]/n;
+					estimate[m] += N*mean;
+					if (n > 1 && n < N) {
+						double sampleVariance = MAX(0, (sumSquare[m] - n*mean*mean)/(n-1));
+						variance[m] += N*N*(1-n/N)*sampleVariance/n;
+					}
 				}
+				numSample += n;
 			}
+			if (ctx.config.inputSampleError <= 0 || numSample >= numInVector) {
+				break;
+			}
+			if (1.96*sqrt(variance[0]) <= ctx.config.inputSampleError*estimate[0] && 1.96*sqrt(variance[4]) <= ctx.config.inputSampleError*estimate[4]) {
+				break;
+			}
+			sampleSize *= 2;
 		}
+		job.numInputVectorSimulated += numSample;		// the last sample includes all the earlier ones
 		
-		if (cell.memCellType == Type::RRAM || cell.memCellType == Type::FeFET) {
-			if (!parallelRead) {  
-				conductance.push_back((double) columnG/activatedRow);
-			} else {
-				conductance.push_back(columnG);
+		for (int m=0; m<4; m++) {
+			job.inputSampleLatencyError[m] = MAX(job.inputSampleLatencyError[m], estimate[m] > 0? sqrt(variance[m])/estimate[m] : 0);
+			job.inputSampleEnergy[m] += estimate[4+m];
+			job.inputSampleEnergyVariance[m] += variance[4+m];
+		}
+	}
+}
+
+
+static void EstimateSubArrays(SimulationContext& ctx, SubArray *subArray, vector<SubArrayJob> &job, int numInVector, MemCell& cell) {
+	// fork-join over the subArrays of this PE: one task per subArray, each on its own copy of subArray (activityRowRead and levelOutput are set per input vector),
+	// the taskloop waits for all of them and SubArrayResult then combines them in the original order, so the results do not depend on the scheduling
+	if (ctx.subArrayStreamMode == streamReplay || ctx.subArrayDeferMode == deferCollect) {
+		return;
+	}
+	int numJob = job.size();
+	SimulationContext *context = &ctx;
+	MemCell *jobCell = &cell;
+	if (ctx.subArrayDeferMode == deferSpawn) {
+		// layer tasks: no wait here, the jobs are kept in ctx until the second pass takes their results (ChipLayerPerformance waits for the tasks)
+		for (int k=0; k<numJob; k++) {
+			SubArrayJob *deferred = new SubArrayJob(job[k]);
+			ctx.subArrayDeferredJob.push_back(deferred);
+			bool splitPatterns = (numJob == 1);
+			#pragma omp task firstprivate(deferred)
+			{
+				ParamBinding binding(*context);
+				SubArray *taskSubArray = new SubArray(*subArray);
+				SubArrayEstimate(*context, taskSubArray, *deferred, numInVector, *jobCell, splitPatterns);
+				delete taskSubArray;
 			}
-		} else {
-			conductance.push_back(columnG);
 		}
+		return;
 	}
-	// covert conductance to resistance
-	for (int i=0; i<weight[0].size(); i++) {
-		resistance.push_back((double) 1.0/conductance[i]);
+	if (numJob == 1 || omp_get_num_threads() == 1) {
+		for (int k=0; k<numJob; k++) {
+			SubArrayEstimate(ctx, subArray, job[k], numInVector, cell, numJob == 1);
+		}
+		return;
 	}
-		
-	return resistance;
-	resistance.clear();
-} 
+	SubArrayJob *jobs = &job[0];
+	#pragma omp taskloop grainsize(1)
+	for (int k=0; k<numJob; k++) {
+		ParamBinding binding(*context);
+		SubArray *taskSubArray = new SubArray(*subArray);
+		SubArrayEstimate(*context, taskSubArray, jobs[k], numInVector, *jobCell, false);
+		delete taskSubArray;
+	}
+}
 
 
+static void SubArrayResult(SimulationContext& ctx, const SubArrayJob &job, double *readLatency, double *readDynamicEnergy, double *leakage, 
+								double *latencyADC, double *latencyAccum, double *latencyOther, double *energyADC, double *energyAccum, double *energyOther) {
+	vector<double> estimate;
+	if (ctx.subArrayDeferMode == deferSpawn) {
+		// first pass of the layer tasks: the estimate is still running, the reductions of this pass are discarded
+		estimate.assign(9, 0);
+	} else if (ctx.subArrayDeferMode == deferCollect) {
+		if (ctx.subArrayDeferredCall >= ctx.subArrayDeferredJob.size()) {
+			cout << "ERROR!: the second pass of a layer takes more subArrays than its first pass spawned" << endl;
+			exit(-1);
+		}
+		SubArrayJob *deferred = ctx.subArrayDeferredJob[ctx.subArrayDeferredCall];
+		ctx.subArrayDeferredJob[ctx.subArrayDeferredCall++] = NULL;
+		ctx.subArrayDeferMode = deferOff;
+		SubArrayResult(ctx, *deferred, readLatency, readDynamicEnergy, leakage, latencyADC, latencyAccum, latencyOther, energyADC, energyAccum, energyOther);
+		ctx.subArrayDeferMode = deferCollect;
+		delete deferred;
+		return;
+	} else if (ctx.subArrayStreamMode == streamReplay) {
+		if (ctx.subArrayStreamCall >= ctx.subArrayStreamCost.size()) {
+			cout << "ERROR!: the final pass of a streamed layer evaluates more subArrays than its chunks" << endl;
+			exit(-1);
+		}
+		estimate = ctx.subArrayStreamCost[ctx.subArrayStreamCall++];
+	} else {
+		estimate = job.estimate;
+		ctx.numInputVectorTotal += job.numInputVectorTotal;
+		ctx.numInputVectorSimulated += job.numInputVectorSimulated;
+		ctx.numInputPattern += job.numInputPattern;
+		for (int m=0; m<4; m++) {
+			ctx.inputSampleLatencyError[m] = MAX(ctx.inputSampleLatencyError[m], job.inputSampleLatencyError[m]);
+			ctx.inputSampleEnergy[m] += job.inputSampleEnergy[m];
+			ctx.inputSampleEnergyVariance[m] += job.inputSampleEnergyVariance[m];
+		}
+		if (ctx.subArrayStreamMode == streamAccumulate) {
+			if (ctx.subArrayStreamCall == ctx.subArrayStreamCost.size()) {
+				ctx.subArrayStreamCost.push_back(vector<double>(9, 0));
+			}
+			vector<double> &cost = ctx.subArrayStreamCost[ctx.subArrayStreamCall++];
+			for (int m=0; m<8; m++) {
+				cost[m] += estimate[m];
+			}
+			cost[8] = estimate[8];
+		}
+	}
+	
+	*readLatency = estimate[0];
+	*latencyADC = estimate[1];
+	*latencyAccum = estimate[2];
+	*latencyOther = estimate[3];
+	*readDynamicEnergy = estimate[4];
+	*energyADC = estimate[5];
+	*energyAccum = estimate[6];
+	*energyOther = estimate[7];
+	*leakage = estimate[8];
+}
 
 
+void SubArrayCalculatePerformance(SimulationContext& ctx, SubArray *subArray, const LevelMatrixView &subArrayMemory, const MatrixView &subArrayInput, int numInVector, MemCell& cell,
+								double *readLatency, double *readDynamicEnergy, double *leakage, double *latencyADC, double *latencyAccum, double *latencyOther,
+								double *energyADC, double *energyAccum, double *energyOther) {
+	vector<SubArrayJob> job(1, SubArrayJob(subArrayMemory, subArrayInput));
+	EstimateSubArrays(ctx, subArray, job, numInVector, cell);
+	SubArrayResult(ctx, job[0], readLatency, readDynamicEnergy, leakage, latencyADC, latencyAccum, latencyOther, energyADC, energyAccum, energyOther);
+}
 
 
+vector<uint64_t> GetInputVector(const MatrixView &input, int numInput, double *activityRowRead) {
+	// pack the input bit-plane of one vector, 64 wordlines per word (bit i%64 of word i/64 is row i)
+	vector<uint64_t> packed((input.numRow+63)/64, 0);
+	double numofreadrow = 0;  // initialize readrowactivity parameters
+	if (input.NonzeroIndexed()) {
+		// only the nonzero rows are visited, an input vector of a sparse (ReLU) layer is often empty
+		vector<int> nonzeroRow(input.numRow);
+		int numNonzero = input.NonzeroRows(numInput, nonzeroRow.data());
+		bool binary = input.IndexOnly();
+		for (int n=0; n<numNonzero; n++) {
+			int i = nonzeroRow[n];
+			if (binary || (int) *input.Element(i, numInput) == 1) {
+				packed[i/64] |= (uint64_t) 1 << (i%64);
+			}
+		}
+		numofreadrow = numNonzero;
+	} else {
+		// input traces are stored vector-major, so the rows of one vector are usually a contiguous read
+		bool contiguous = input.RowContiguous();
+		const double *column = contiguous? input.Element(0, numInput) : NULL;
+		int rowStep = input.RowStep();
+		for (int i=0; i<input.numRow; i++) {
+			double x = contiguous? column[(long) i*rowStep] : input(i, numInput);
+			if ((int) x == 1) {
+				packed[i/64] |= (uint64_t) 1 << (i%64);
+			}
+			if (x != 0) {
+				numofreadrow += 1;
+			}
+		}
+	}
+	double totalnumRow = input.numRow;
+	*(activityRowRead) = numofreadrow/totalnumRow;
+	return packed;
+} 
+
 
+vector<double> GetCellConductance(const SimulationContext& ctx, const LevelMatrixView &weight, MemCell& cell, double resCellAccess) {
+	// effective conductance of each cell seen from the sense amp (cell + access device + wire), only depends on the mapped weights
+	// stored row by row with ColumnKernelStride(numCol) entries per row (zero padded) for the column kernel
+	int stride = ColumnKernelStride(weight.numCol);
+	vector<double> conductance(weight.numRow*stride, 0);
+	ctx.cellConductanceKernel(weight, cell, resCellAccess, &conductance[0], stride);
+	if (ctx.variationTrial >= 0) {
+		ApplyDeviceVariation(ctx, weight, cell, &conductance[0], stride);
+	}
+	return conductance;
+}
+
+
+vector<double> GetColumnResistance(const SimulationContext& ctx, const vector<uint64_t> &input, const vector<double> &conductance, int numCol) {
+	// conductance is pre-computed by GetCellConductance, only the activated rows (set bits) are summed up by the column kernel
+	vector<double> columnG(ColumnKernelStride(numCol), 0);
+	int activatedRow = 0;
+	for (int w=0; w<input.size(); w++) {
+		activatedRow += __builtin_popcountll(input[w]);
+	}
+	ColumnKernelAccumulate(&input[0], input.size(), &conductance[0], columnG.size(), &columnG[0]);
+	
+	vector<double> resistance(numCol);
+	ctx.columnResistanceKernel(&columnG[0], numCol, activatedRow, &resistance[0]);
+	return resistance;
+}
@@ -38,24 +38,30 @@
 
 #ifndef PROCESSINGUNIT_H_
 #define PROCESSINGUNIT_H_
+#include <stdint.h>
 #include "InputParameter.h"
 #include "Technology.h"
 #include "MemCell.h"
 #include "SubArray.h"
+#include "MatrixView.h"
  
+class SimulationContext;
+
 /*** Functions ***/
-void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParameter, Technology& tech, MemCell& cell, int _numSubArrayRowNM, int _numSubArrayColNM, int _numSubArrayRowCM, int _numSubArrayColCM);
-vector<double> ProcessingUnitCalculateArea(SubArray *subArray, int numSubArrayRow, int numSubArrayCol, bool NMpe, double *height, double *width, double *bufferArea);
-double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vector<double> > &newMemory, const vector<vector<double> > &oldMemory, const vector<vector<double> > &inputVector, 
+void ProcessingUnitInitialize(SimulationContext& ctx, SubArray *& subArray, InputParameter& inputParameter, Technology& tech, MemCell& cell, int _numSubArrayRowNM, int _numSubArrayColNM, int _numSubArrayRowCM, int _numSubArrayColCM);
+vector<double> ProcessingUnitCalculateArea(SimulationContext& ctx, SubArray *subArray, int numSubArrayRow, int numSubArrayCol, bool NMpe, double *height, double *width, double *bufferArea);
+void ProcessingUnitCalculatePerformance(SimulationContext& ctx, SubArray *subArray, const LevelMatrixView &newMemory, const LevelMatrixView &oldMemory, const MatrixView &inputVector, 
 										int arrayDupRow, int arrayDupCol, int numSubArrayRow, int numSubArrayCol, int weightMatrixRow, int weightMatrixCol, 
 										int numInVector, MemCell& cell, bool NMpe, double *readLatency, double *readDynamicEnergy, double *leakage, 
 										double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
 										double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther);
 
-vector<vector<double> > CopySubArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol);
-vector<vector<double> > CopySubInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow);
-vector<double> GetInputVector(const vector<vector<double> > &input, int numInput, double *activityRowRead);
-vector<double> GetColumnResistance(const vector<double> &input, const vector<vector<double> > &weight, MemCell& cell, bool parallelRead, double resCellAccess);
+void SubArrayCalculatePerformance(SimulationContext& ctx, SubArray *subArray, const LevelMatrixView &subArrayMemory, const MatrixView &subArrayInput, int numInVector, MemCell& cell,
+								double *readLatency, double *readDynamicEnergy, double *leakage, double *latencyADC, double *latencyAccum, double *latencyOther,
+								double *energyADC, double *energyAccum, double *energyOther);
+vector<uint64_t> GetInputVector(const MatrixView &input, int numInput, double *activityRowRead);
+vector<double> GetCellConductance(const SimulationContext& ctx, const LevelMatrixView &weight, MemCell& cell, double resCellAccess);
+vector<double> GetColumnResistance(const SimulationContext& ctx, const vector<uint64_t> &input, const vector<double> &conductance, int numCol);
 
 
 #endif /* PROCESSINGUNIT_H_ */
\ No newline at end of file
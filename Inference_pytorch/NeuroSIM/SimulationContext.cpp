@@ -0,0 +1,106 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include "Buffer.h"
+#include "Bus.h"
+#include "DFF.h"
+#include "HTree.h"
+#include "AdderTree.h"
+#include "Sigmoid.h"
+#include "BitShifter.h"
+#include "MaxPooling.h"
+#include "SubArray.h"
+#include "TracePrefetch.h"
+#include "SimulationContext.h"
+
+using namespace std;
+
+SimulationContext::SimulationContext(): globalBusWidth(0), numBufferCore(0), globalBuffer(NULL), GhTree(NULL), Gaccumulation(NULL), Gsigmoid(NULL), 
+GreLu(NULL), maxPool(NULL), tracePrefetch(NULL), numInBufferCore(0), numOutBufferCore(0), subArrayInPE(NULL), inputBufferCM(NULL), outputBufferCM(NULL), 
+inputBufferNM(NULL), outputBufferNM(NULL), hTreeCM(NULL), hTreeNM(NULL), accumulationCM(NULL), accumulationNM(NULL), sigmoidCM(NULL), sigmoidNM(NULL), 
+reLuCM(NULL), reLuNM(NULL), adderTreeNM(NULL), adderTreeCM(NULL), busInputNM(NULL), busOutputNM(NULL), busInputCM(NULL), busOutputCM(NULL), 
+bufferInputNM(NULL), bufferOutputNM(NULL), bufferInputCM(NULL), bufferOutputCM(NULL), cellConductanceKernel(NULL), columnResistanceKernel(NULL), 
+numInputVectorTotal(0), numInputVectorSimulated(0), numInputPattern(0), inputSampleLatencyError(4, 0), inputSampleEnergy(4, 0), inputSampleEnergyVariance(4, 0), 
+variationTrial(-1), variationLayer(0), subArrayStreamMode(streamOff), subArrayStreamCall(0), 
+subArrayDeferMode(deferOff), subArrayDeferredCall(0) {
+}
+
+SimulationContext::~SimulationContext() {
+	delete tracePrefetch;
+	delete globalBuffer;
+	delete GhTree;
+	delete Gaccumulation;
+	delete Gsigmoid;
+	delete GreLu;
+	delete maxPool;
+	delete subArrayInPE;
+	delete inputBufferCM;
+	delete outputBufferCM;
+	delete inputBufferNM;
+	delete outputBufferNM;
+	delete hTreeCM;
+	delete hTreeNM;
+	delete accumulationCM;
+	delete accumulationNM;
+	delete sigmoidCM;
+	delete sigmoidNM;
+	delete reLuCM;
+	delete reLuNM;
+	delete adderTreeNM;
+	delete adderTreeCM;
+	delete busInputNM;
+	delete busOutputNM;
+	delete busInputCM;
+	delete busOutputCM;
+	delete bufferInputNM;
+	delete bufferOutputNM;
+	delete bufferInputCM;
+	delete bufferOutputCM;
+}
+
+void SimulationContext::Bind() {
+	param = &config;
+}
+
+ParamBinding::ParamBinding(SimulationContext& ctx): previous(param) {
+	ctx.Bind();
+}
+
+ParamBinding::~ParamBinding() {
+	param = previous;
+}
@@ -0,0 +1,160 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef SIMULATIONCONTEXT_H_
+#define SIMULATIONCONTEXT_H_
+
+#include <random>
+#include <vector>
+#include "InputParameter.h"
+#include "Technology.h"
+#include "MemCell.h"
+#include "MatrixView.h"
+#include "Param.h"
+
+using namespace std;
+
+class Buffer;
+class Bus;
+class DFF;
+class HTree;
+class AdderTree;
+class Sigmoid;
+class BitShifter;
+class MaxPooling;
+class SubArray;
+class TracePrefetch;
+struct SubArrayJob;
+
+/* Streaming (param->inputChunkSize): the subArray results of each chunk of input vectors are summed per call of
+   SubArrayCalculatePerformance (in call order), then replayed to the final pass of the layer over all input vectors */
+enum SubArrayStreamMode {streamOff, streamAccumulate, streamReplay};
+
+/* Layer tasks (ChipLayerPerformance in a team of threads): a first pass over the tiles and PEs of the layer spawns the subArrays of all
+   of them as tasks and waits for them, the second pass takes their results in call order and does the reductions of the PEs, tiles and chip */
+enum SubArrayDeferMode {deferOff, deferSpawn, deferCollect};
+
+/* State of one simulated chip: the configuration, the circuit modules of the chip, tile and PE levels built by
+   ChipInitialize / TileInitialize / ProcessingUnitInitialize, and the per-layer statistics of ChipCalculatePerformance.
+   Several contexts can be simulated concurrently, each by its own thread (see Bind) */
+class SimulationContext {
+public:
+	SimulationContext();
+	virtual ~SimulationContext();
+
+	/* Functions */
+	void Bind();	/* makes param of the calling thread point to this context's configuration, OpenMP regions pass it on with copyin(param),
+					   a task simulating the context binds it with a ParamBinding instead */
+
+	/* Configuration */
+	Param config;
+	mt19937 gen;	/* random number generator engine */
+	InputParameter inputParameter;
+	Technology tech;
+	MemCell cell;
+
+	/* Chip */
+	double globalBusWidth;
+	int numBufferCore;
+	Buffer *globalBuffer;
+	HTree *GhTree;
+	AdderTree *Gaccumulation;
+	Sigmoid *Gsigmoid;
+	BitShifter *GreLu;
+	MaxPooling *maxPool;
+	TracePrefetch *tracePrefetch;	/* NULL: ChipCalculatePerformance loads the traces itself */
+
+	/* Tile */
+	int numInBufferCore, numOutBufferCore;
+	SubArray *subArrayInPE;
+	Buffer *inputBufferCM, *outputBufferCM, *inputBufferNM, *outputBufferNM;
+	HTree *hTreeCM, *hTreeNM;
+	AdderTree *accumulationCM, *accumulationNM;
+	Sigmoid *sigmoidCM, *sigmoidNM;
+	BitShifter *reLuCM, *reLuNM;
+
+	/* Processing unit */
+	AdderTree *adderTreeNM, *adderTreeCM;
+	Bus *busInputNM, *busOutputNM, *busInputCM, *busOutputCM;
+	DFF *bufferInputNM, *bufferOutputNM, *bufferInputCM, *bufferOutputCM;
+	void (*cellConductanceKernel)(const LevelMatrixView &, MemCell&, double, double *, int);	/* selected in ProcessingUnitInitialize */
+	void (*columnResistanceKernel)(const double *, int, int, double *);
+
+	/* Per-layer statistics (reset by the caller) */
+	double numInputVectorTotal;			/* # of input vectors seen by the subArrays */
+	double numInputVectorSimulated;		/* # of them simulated (all of them, or the sampled ones with param->inputSampling) */
+	double numInputPattern;				/* # of distinct input patterns evaluated for the simulated vectors (deduplication) */
+	/* param->inputSampling, each for the total, ADC, accumulation and other part */
+	vector<double> inputSampleLatencyError;		/* max relative standard error of the subArray latency */
+	vector<double> inputSampleEnergy;			/* sum of the estimated subArray dynamic energy */
+	vector<double> inputSampleEnergyVariance;	/* variance of that sum */
+
+	/* Monte Carlo device variation (param->monteCarloTrials) */
+	int variationTrial;		/* >= 0: trial simulated, the cell conductances are perturbed by ApplyDeviceVariation; -1: nominal */
+	int variationLayer;		/* layer simulated in that trial */
+
+	/* Streaming */
+	SubArrayStreamMode subArrayStreamMode;
+	int subArrayStreamCall;						/* calls so far in the current pass */
+	vector<vector<double> > subArrayStreamCost;	/* summed results of each call */
+
+	/* Layer tasks */
+	SubArrayDeferMode subArrayDeferMode;
+	int subArrayDeferredCall;					/* results taken so far in the second pass */
+	vector<SubArrayJob *> subArrayDeferredJob;	/* jobs spawned by the first pass, each freed when its result is taken */
+
+private:
+	SimulationContext(const SimulationContext &);
+	SimulationContext &operator=(const SimulationContext &);
+};
+
+/* Binds param of the calling thread to a context for the lifetime of the object and restores the previous binding in the destructor,
+   for the tasks that simulate a context on whichever thread of the team runs them (the circuit modules still read param) */
+class ParamBinding {
+public:
+	ParamBinding(SimulationContext& ctx);
+	virtual ~ParamBinding();
+
+private:
+	ParamBinding(const ParamBinding &);
+	ParamBinding &operator=(const ParamBinding &);
+
+	Param *previous;
+};
+
+#endif /* SIMULATIONCONTEXT_H_ */
@@ -989,7 +989,7 @@ void SubArray::CalculateLatency(double columnRes, const vector<double> &columnRe
 	}
 }
 
-void SubArray::CalculatePower(const vector<double> &columnResistance) {
+void SubArray::CalculatePower(const vector<double> &columnResistance, bool reuseColumn) {
 	if (!initialized) {
 		cout << "[Subarray] Error: Require initialization first!" << endl;
 	} else {
@@ -1067,7 +1067,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 					mux.CalculatePower(numColMuxed);	// Mux still consumes energy during row-by-row read
 					muxDecoder.CalculatePower(numColMuxed, 1);
 				}
-				multilevelSenseAmp.CalculatePower(columnResistance, 1);
+				multilevelSenseAmp.CalculatePower(columnResistance, 1, reuseColumn);
 				multilevelSAEncoder.CalculatePower(numColMuxed);
 				if (numReadPulse > 1) {
 					shiftAdd.CalculatePower(numColMuxed);
@@ -1141,7 +1141,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 				wlSwitchMatrix.CalculatePower(numColMuxed, 2*numWriteOperationPerRow*numRow*activityRowWrite, activityRowRead, activityColWrite);
 				precharger.CalculatePower(numColMuxed, numWriteOperationPerRow*numRow*activityRowWrite);
 				sramWriteDriver.CalculatePower(numWriteOperationPerRow*numRow*activityRowWrite);
-				multilevelSenseAmp.CalculatePower(columnResistance, 1);
+				multilevelSenseAmp.CalculatePower(columnResistance, 1, reuseColumn);
 				multilevelSAEncoder.CalculatePower(numColMuxed);
 				
 				// Array
@@ -1171,7 +1171,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 				wlSwitchMatrix.CalculatePower(numColMuxed, 2*numWriteOperationPerRow*numRow*activityRowWrite, activityRowRead, activityColWrite);
 				precharger.CalculatePower(numColMuxed, numWriteOperationPerRow*numRow*activityRowWrite);
 				sramWriteDriver.CalculatePower(numWriteOperationPerRow*numRow*activityRowWrite);
-				multilevelSenseAmp.CalculatePower(columnResistance, 1);
+				multilevelSenseAmp.CalculatePower(columnResistance, 1, reuseColumn);
 				multilevelSAEncoder.CalculatePower(numColMuxed);
 				if (numReadPulse > 1) {
 					shiftAdd.CalculatePower(numColMuxed);
@@ -1221,7 +1221,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 					mux.CalculatePower(numColMuxed);	// Mux still consumes energy during row-by-row read
 					muxDecoder.CalculatePower(numColMuxed, 1);
 				}
-				multilevelSenseAmp.CalculatePower(columnResistance, numRow*activityRowRead);
+				multilevelSenseAmp.CalculatePower(columnResistance, numRow*activityRowRead, reuseColumn);
 				if (avgWeightBit > 1) {
 					multilevelSAEncoder.CalculatePower(numRow*activityRowRead*numColMuxed);
 				}
@@ -1289,7 +1289,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 					mux.CalculatePower(numColMuxed);	// Mux still consumes energy during row-by-row read
 					muxDecoder.CalculatePower(numColMuxed, 1);
 				}
-				multilevelSenseAmp.CalculatePower(columnResistance, 1);
+				multilevelSenseAmp.CalculatePower(columnResistance, 1, reuseColumn);
 				multilevelSAEncoder.CalculatePower(numColMuxed);
 				if (numReadPulse > 1) {
 					shiftAdd.CalculatePower(numColMuxed);
@@ -1349,7 +1349,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 					mux.CalculatePower(numColMuxed);	// Mux still consumes energy during row-by-row read
 					muxDecoder.CalculatePower(numColMuxed, 1);
 				}
-				rowCurrentSenseAmp.CalculatePower(columnResistance, numRow*activityRowRead);
+				rowCurrentSenseAmp.CalculatePower(columnResistance, numRow*activityRowRead, reuseColumn);
 				adder.CalculatePower(numColMuxed*numRow*activityRowRead, numReadCells);
 				dff.CalculatePower(numColMuxed*numRow*activityRowRead, numReadCells*(adder.numBit+1)); 
 				
@@ -1405,7 +1405,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 					mux.CalculatePower(numColMuxed);	// Mux still consumes energy during row-by-row read
 					muxDecoder.CalculatePower(numColMuxed, 1);
 				}
-				multilevelSenseAmp.CalculatePower(columnResistance, 1);
+				multilevelSenseAmp.CalculatePower(columnResistance, 1, reuseColumn);
 				multilevelSAEncoder.CalculatePower(numColMuxed);
 				
 				// Read
@@ -1455,7 +1455,7 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 					mux.CalculatePower(numColMuxed);	// Mux still consumes energy during row-by-row read
 					muxDecoder.CalculatePower(numColMuxed, 1);
 				}
-				multilevelSenseAmp.CalculatePower(columnResistance, 1);
+				multilevelSenseAmp.CalculatePower(columnResistance, 1, reuseColumn);
 				multilevelSAEncoder.CalculatePower(numColMuxed);
 				if (numReadPulse > 1) {
 					shiftAdd.CalculatePower(numColMuxed);
@@ -1498,6 +1498,69 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 	}
 }
 
+void SubArray::CalculatePerformance(const vector<double> &columnResistance) {
+	// latency and power of one input vector = activity part + sense amp part
+	// only the sense amps see the column resistance and their latency/energy are plain additive terms,
+	// so the rest of the peripheries is evaluated once per activityRowRead (at most numRow+1 values) and cached
+	map<double, vector<double> >::iterator it = activityCost.find(activityRowRead);
+	if (it == activityCost.end()) {
+		vector<double> noColumn;
+		CalculateLatency(1e20, noColumn);
+		CalculatePower(noColumn, true);
+		double cost[] = {readLatency, readLatencyADC, readLatencyAccum, readLatencyOther, 
+						readDynamicEnergy, readDynamicEnergyADC, readDynamicEnergyAccum, readDynamicEnergyOther, leakage};
+		it = activityCost.insert(make_pair(activityRowRead, vector<double>(cost, cost+9))).first;
+	}
+	const vector<double> &cost = it->second;
+	CalculateColumnPerformance(columnResistance);
+	
+	readLatency = cost[0] + columnReadLatency;
+	readDynamicEnergy = cost[4] + columnReadDynamicEnergy;
+	readLatencyAccum = cost[2];
+	readLatencyOther = cost[3];
+	readDynamicEnergyAccum = cost[6];
+	readDynamicEnergyOther = cost[7];
+	leakage = cost[8];
+	if (conventionalSequential || conventionalParallel) {	// only these modes assign the ADC breakdown, which includes the sense amp
+		readLatencyADC = cost[1] + columnReadLatency;
+		readDynamicEnergyADC = cost[5] + columnReadDynamicEnergy;
+	} else {
+		readLatencyADC = cost[1];
+		readDynamicEnergyADC = cost[5];
+	}
+}
+
+void SubArray::CalculateColumnPerformance(const vector<double> &columnResistance) {
+	// sense amp latency and energy of one input vector, same calls as in CalculateLatency and CalculatePower
+	columnReadLatency = 0;
+	columnReadDynamicEnergy = 0;
+	if (cell.memCellType == Type::SRAM) {
+		if (conventionalParallel || BNNparallelMode || XNORparallelMode) {
+			multilevelSenseAmp.CalculateLatency(columnResistance, numColMuxed, 1);
+			multilevelSenseAmp.CalculatePower(columnResistance, 1, true);
+			columnReadLatency = multilevelSenseAmp.readLatency;
+			columnReadDynamicEnergy = multilevelSenseAmp.readDynamicEnergy;
+		}
+	} else if (cell.memCellType == Type::RRAM || cell.memCellType == Type::FeFET) {
+		if (conventionalSequential) {
+			multilevelSenseAmp.CalculateLatency(columnResistance, numColMuxed, numRow*activityRowRead);
+			multilevelSenseAmp.CalculatePower(columnResistance, numRow*activityRowRead, true);
+			columnReadLatency = multilevelSenseAmp.readLatency;
+			columnReadDynamicEnergy = multilevelSenseAmp.readDynamicEnergy;
+		} else if (conventionalParallel || BNNparallelMode || XNORparallelMode) {
+			multilevelSenseAmp.CalculateLatency(columnResistance, numColMuxed, 1);
+			multilevelSenseAmp.CalculatePower(columnResistance, 1, true);
+			columnReadLatency = multilevelSenseAmp.readLatency;
+			columnReadDynamicEnergy = multilevelSenseAmp.readDynamicEnergy;
+		} else if (BNNsequentialMode || XNORsequentialMode) {
+			rowCurrentSenseAmp.CalculateLatency(columnResistance, numColMuxed, numRow*activityRowRead);
+			rowCurrentSenseAmp.CalculatePower(columnResistance, numRow*activityRowRead, true);
+			columnReadLatency = rowCurrentSenseAmp.readLatency;
+			columnReadDynamicEnergy = rowCurrentSenseAmp.readDynamicEnergy;
+		}
+	}
+}
+
 void SubArray::PrintProperty() {
 
 	if (cell.memCellType == Type::SRAM) {
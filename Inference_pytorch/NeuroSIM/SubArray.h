@@ -40,6 +40,7 @@
 #define SUBARRAY_H_
 
 #include <vector>
+#include <map>
 #include "typedef.h"
 #include "InputParameter.h"
 #include "Technology.h"
@@ -81,7 +82,9 @@ public:
 	void Initialize(int _numRow, int _numCol, double _unitWireRes);
 	void CalculateArea();
 	void CalculateLatency(double _rampInput, const vector<double> &columnResistance);
-	void CalculatePower(const vector<double> &columnResistance);
+	void CalculatePower(const vector<double> &columnResistance, bool reuseColumn = false);
+	void CalculatePerformance(const vector<double> &columnResistance);
+	void CalculateColumnPerformance(const vector<double> &columnResistance);
 
 	/* Properties */	
 	bool initialized;	   // Initialization flag
@@ -130,6 +133,9 @@ public:
 
 	int levelOutput;
 	
+	map<double, vector<double> > activityCost;	// latency, energy (with breakdown) and leakage without the sense amp part, per activityRowRead
+	double columnReadLatency, columnReadDynamicEnergy;	// sense amp part of the last vector
+	
 	ReadCircuitMode readCircuitMode;
 	int numWriteCellPerOperationFPGA;   // Parameter for SRAM
 	int numWriteCellPerOperationMemory;
@@ -48,20 +48,21 @@
 #include "InputParameter.h"
 #include "Technology.h"
 #include "MemCell.h"
+#include "MatrixView.h"
+
+class SimulationContext;
  
 using namespace std;
 
 /*** Functions ***/
-void TileInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, double _numPENM, double _peSizeNM, double _numPECM, double _peSizeCM);
-vector<double> TileCalculateArea(double numPE, double peSize, bool NMTile, double *height, double *width);
-void TileCalculatePerformance(const vector<vector<double> > &newMemory, const vector<vector<double> > &oldMemory, const vector<vector<double> > &inputVector, 
+void TileInitialize(SimulationContext& ctx, InputParameter& inputParameter, Technology& tech, MemCell& cell, double _numPENM, double _peSizeNM, double _numPECM, double _peSizeCM);
+vector<double> TileCalculateArea(SimulationContext& ctx, double numPE, double peSize, bool NMTile, double *height, double *width);
+void TileCalculatePerformance(SimulationContext& ctx, const LevelMatrixView &newMemory, const LevelMatrixView &oldMemory, const MatrixView &inputVector, 
 			int novelMap, double numPE, double peSize, 
 			int speedUpRow, int speedUpCol, int weightMatrixRow, int weightMatrixCol, int numInVector, MemCell& cell, double *readLatency, double *readDynamicEnergy, double *leakage,
 			double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
 			double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther);
 		
-vector<vector<double> > CopyPEArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol);
-vector<vector<double> > CopyPEInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow);
 	
 
 #endif /* TILE_H_ */
\ No newline at end of file
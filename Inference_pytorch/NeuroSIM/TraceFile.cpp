@@ -0,0 +1,282 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <omp.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include "TraceFile.h"
+
+using namespace std;
+
+thread_local bool traceLoadDeferred = false;
+
+static const char traceMagic[8] = {'N', 'S', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+uint32_t TraceCRC32(const unsigned char *data, size_t size) {
+	static uint32_t table[256];
+	static bool tableReady = false;
+	#pragma omp critical(TraceCRC32Table)
+	{
+		if (!tableReady) {
+			for (uint32_t i=0; i<256; i++) {
+				uint32_t c = i;
+				for (int k=0; k<8; k++) {
+					c = (c & 1)? 0xEDB88320 ^ (c >> 1) : c >> 1;
+				}
+				table[i] = c;
+			}
+			tableReady = true;
+		}
+	}
+	uint32_t crc = 0xFFFFFFFF;
+	for (size_t i=0; i<size; i++) {
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFF;
+}
+
+TraceFile::TraceFile(const string &filename, bool streamed) {
+	good = binary = sparse = false;
+	numRow = numCol = 0;
+	memset(&header, 0, sizeof(header));
+	csv = NULL;
+	mapping = NULL;
+	mappingSize = rowBytes = 0;
+	vectorOffset = NULL;
+	vectorRecord = NULL;
+	name = filename;
+	
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0 || S_ISDIR(status.st_mode)) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return;
+	}
+	char magic[sizeof(traceMagic)];
+	if (status.st_size < (off_t) sizeof(TraceHeader) || pread(fd, magic, sizeof(magic), 0) != (ssize_t) sizeof(magic) || memcmp(magic, traceMagic, sizeof(magic)) != 0) {
+		// CSV fallback
+		close(fd);
+		csv = new CsvParser(filename, streamed);
+		good = csv->good;
+		numRow = csv->numRow;
+		numCol = csv->numCol;
+		return;
+	}
+	
+	double start = omp_get_wtime();
+	mappingSize = status.st_size;
+	// shared read-only mapping: concurrent simulations of the same trace share the page cache
+	void *data = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		mapping = NULL;
+		return;
+	}
+	mapping = (const unsigned char *) data;
+	good = binary = true;
+	memcpy(&header, mapping, sizeof(header));
+	
+	if (header.version != traceVersion) {
+		ostringstream error;
+		error << "ERROR!: " << filename << " is a version " << header.version << " trace, only version " << traceVersion << " is supported!";
+		LoadFailed(error.str());
+	}
+	if (header.quantization != traceFixedPoint || header.dtype > traceSparse || header.kind > traceInput || (header.dtype == traceSparse && header.kind != traceInput)) {
+		LoadFailed("ERROR!: " + filename + " has an unsupported trace kind, data type or quantization format!");
+	}
+	numRow = header.rows;
+	numCol = header.cols;
+	if (header.payloadSize > mappingSize - sizeof(header)) {
+		LoadFailed("ERROR!: " + filename + " is truncated, the trace header does not match the file size!");
+	}
+	if (TraceCRC32(mapping + sizeof(header), header.payloadSize) != header.crc32) {
+		LoadFailed("ERROR!: " + filename + " is corrupted, the trace checksum does not match!");
+	}
+	bool consistent;
+	if (header.dtype == traceSparse) {
+		sparse = true;
+		size_t tableSize = (numCol + 1) * sizeof(uint64_t);
+		consistent = tableSize <= header.payloadSize;
+		if (consistent) {
+			vectorOffset = (const uint64_t *) (mapping + sizeof(header));	// the header keeps the table 8-byte aligned
+			vectorRecord = mapping + sizeof(header) + tableSize;
+			consistent = vectorOffset[0] == 0 && vectorOffset[numCol] == header.payloadSize - tableSize;
+			for (int col=0; consistent && col<numCol; col++) {
+				consistent = vectorOffset[col] <= vectorOffset[col+1];
+			}
+		}
+	} else {
+		rowBytes = (header.dtype == traceBit)? (numCol + 7)/8 : numCol * (header.dtype == traceInt8? 1 : 2);
+		consistent = header.payloadSize == rowBytes * numRow;
+	}
+	if (!consistent) {
+		LoadFailed("ERROR!: " + filename + " has a payload that does not match its shape!");
+	}
+	#pragma omp critical
+	{
+		csvBytesTotal += mappingSize;
+		csvSecondsTotal += omp_get_wtime() - start;
+	}
+}
+
+TraceFile::~TraceFile() {
+	delete csv;
+	if (mapping) {
+		munmap((void *) mapping, mappingSize);
+	}
+}
+
+void TraceFile::LoadFailed(const string &message) {
+	munmap((void *) mapping, mappingSize);
+	mapping = NULL;
+	TraceLoadFailed(message, -1);
+}
+
+const double *TraceFile::Row(int row, int colStart, int numValue, int *size, double *buffer) const {
+	if (!binary && csv->indexed) {
+		return csv->Row(row, colStart, numValue, size, buffer);
+	}
+	if (!binary) {
+		int rowSize;
+		const double *value = csv->Row(row, &rowSize);
+		*size = max(0, min(numValue, rowSize - colStart));
+		return (*size > 0)? value + colStart : buffer;
+	}
+	if (sparse) {
+		cout << "ERROR!: " << name << " is a sparse trace, it can only be read by input vector!" << endl;
+		exit(-1);
+	}
+	const unsigned char *value = mapping + sizeof(header) + row * rowBytes;
+	*size = max(0, min(numValue, numCol - colStart));
+	if (header.dtype == traceBit) {
+		for (int i=0, col=colStart; i<*size; i++, col++) {
+			buffer[i] = (value[col >> 3] >> (col & 7)) & 1;
+		}
+	} else if (header.dtype == traceInt8) {
+		for (int i=0, col=colStart; i<*size; i++, col++) {
+			buffer[i] = (int8_t) value[col] * header.scale;
+		}
+	} else {
+		for (int i=0, col=colStart; i<*size; i++, col++) {
+			int16_t v = (int16_t) (value[2*col] | (value[2*col+1] << 8));
+			buffer[i] = v * header.scale;
+		}
+	}
+	return buffer;
+}
+
+static uint64_t ReadVarint(const unsigned char *&p, const unsigned char *end) {
+	uint64_t value = 0;
+	for (int shift=0; p<end && shift<64; shift+=7) {
+		unsigned char byte = *p++;
+		value |= (uint64_t) (byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+	return UINT64_MAX;		// truncated, rejected by the range checks of the caller
+}
+
+int TraceFile::NonzeroRows(int col, int *rows) const {
+	const unsigned char *p = vectorRecord + vectorOffset[col];
+	const unsigned char *end = vectorRecord + vectorOffset[col+1];
+	if (p == end) {
+		return 0;
+	}
+	int count = 0;
+	bool valid = true;
+	int encoding = *p++;
+	if (encoding == sparseRowList) {
+		uint64_t numNonzero = ReadVarint(p, end);
+		uint64_t row = 0;
+		valid = numNonzero <= (uint64_t) numRow;
+		for (uint64_t n=0; valid && n<numNonzero; n++) {
+			row += ReadVarint(p, end) + (n > 0);
+			valid = row < (uint64_t) numRow;
+			rows[count++] = row;
+		}
+	} else if (encoding == sparseRunLength) {
+		uint64_t numRun = ReadVarint(p, end);
+		uint64_t row = 0;
+		valid = numRun <= (uint64_t) numRow;
+		for (uint64_t n=0; valid && n<numRun; n++) {
+			row += ReadVarint(p, end);
+			uint64_t length = ReadVarint(p, end);
+			valid = row <= (uint64_t) numRow && length <= (uint64_t) numRow - row;
+			for (uint64_t i=0; valid && i<length; i++) {
+				rows[count++] = row++;
+			}
+		}
+	} else if (encoding == sparseBitmap && end - p == (numRow + 7)/8) {
+		for (int row=0; row<numRow; row++) {
+			if ((p[row >> 3] >> (row & 7)) & 1) {
+				rows[count++] = row;
+			}
+		}
+	} else {
+		valid = false;
+	}
+	if (!valid) {
+		ostringstream error;
+		error << "ERROR!: input vector " << col << " of " << name << " is not a valid sparse record!";
+		TraceLoadFailed(error.str(), -1);
+	}
+	return count;
+}
+
+void TraceLoadFailed(const string &message, int status) {
+	TraceLoadError error = {message, status};
+	if (traceLoadDeferred) {
+		throw error;
+	}
+	ReportTraceLoadError(error);
+}
+
+void ReportTraceLoadError(const TraceLoadError &error) {
+	(error.status == 1? cerr : cout) << error.message << endl;
+	exit(error.status);
+}
@@ -0,0 +1,127 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef TRACEFILE_H_
+#define TRACEFILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "CsvParser.h"
+
+using namespace std;
+
+/* Binary layer trace written by utee/hook.py (all fields little-endian, 64 bytes), followed by the payload:
+   rows x cols values in row-major order, each row bit-packed (LSB first, padded to a byte) or int8/int16,
+   or for traceSparse input traces the cols+1 uint64 offsets of the input vector records after the offset table, then the records.
+   A record is empty for an input vector without nonzero rows, otherwise a byte giving the encoding followed by
+   sparseRowList:   # of rows, then the gaps between consecutive nonzero rows (the first gap is the first row)
+   sparseRunLength: # of runs, then for each run the # of zero rows before it and its # of nonzero rows
+   sparseBitmap:    the rows bit-packed as in traceBit
+   with all counts as LEB128 varints */
+struct TraceHeader {
+	char magic[8];			/* "NSTRACE" */
+	uint32_t version;		/* traceVersion */
+	uint32_t kind;			/* traceWeight or traceInput */
+	uint32_t dtype;			/* traceBit, traceInt8 or traceInt16 */
+	uint32_t bits;			/* weight precision (wl_weight) or input precision (wl_activate) of the recording */
+	uint32_t mode;			/* NeuroSim operation mode the trace was recorded for (param->operationmode) */
+	uint32_t rows;
+	uint32_t cols;
+	uint32_t crc32;			/* CRC-32 (zlib) of the payload */
+	double scale;			/* value = stored integer * scale */
+	uint64_t payloadSize;	/* Unit: byte */
+	uint32_t quantization;	/* quantization format of the stored values, traceFixedPoint */
+	uint8_t reserved[4];
+};
+
+enum TraceKind {traceWeight = 0, traceInput = 1};
+enum TraceDataType {traceBit = 0, traceInt8 = 1, traceInt16 = 2, traceSparse = 3};
+enum SparseEncoding {sparseRowList = 0, sparseRunLength = 1, sparseBitmap = 2};
+enum TraceQuantization {traceFixedPoint = 0};
+const uint32_t traceVersion = 2;
+
+/* Weight or input trace of a layer: a memory-mapped binary trace if the file starts with the trace magic,
+   otherwise the CSV file is parsed as before, or only indexed by line for a streamed input trace (its chunks parsed by Row) */
+class TraceFile {
+public:
+	TraceFile(const string &filename, bool streamed = false);
+	virtual ~TraceFile();
+
+	/* Functions */
+	const double *Row(int row, int *size, double *buffer) const {	/* values of a row, binary traces are decoded into buffer (numCol values) */
+		return Row(row, 0, numCol, size, buffer);
+	}
+	const double *Row(int row, int colStart, int numValue, int *size, double *buffer) const;	/* values colStart .. colStart+numValue-1 of a row (fewer at the end of the row) */
+	int NonzeroRows(int col, int *rows) const;		/* traceSparse: the nonzero (= 1) rows of input vector col in increasing order, returns their number */
+
+	/* Properties */
+	bool good;			/* false if the file cannot be opened */
+	bool binary;		/* binary trace or CSV file */
+	bool sparse;		/* traceSparse binary trace, read by NonzeroRows instead of Row */
+	int numRow;
+	int numCol;
+	TraceHeader header;	/* binary traces only */
+	string name;		/* file name */
+
+private:
+	TraceFile(const TraceFile &);
+	TraceFile &operator=(const TraceFile &);
+	void LoadFailed(const string &message);		/* TraceLoadFailed from the constructor, the mapping is released first (no destructor if it throws) */
+
+	CsvParser *csv;
+	const unsigned char *mapping;
+	size_t mappingSize;
+	size_t rowBytes;
+	const uint64_t *vectorOffset;	/* traceSparse */
+	const unsigned char *vectorRecord;
+};
+
+uint32_t TraceCRC32(const unsigned char *data, size_t size);
+
+/* Fatal error while loading a layer trace: printed and the simulation stopped right away, or on the loader thread
+   of TracePrefetch (traceLoadDeferred) thrown instead, and reported by the main thread when it takes that layer */
+struct TraceLoadError {
+	string message;
+	int status;		/* exit status, 1: a file that cannot be opened (message printed to cerr) */
+};
+void TraceLoadFailed(const string &message, int status);
+void ReportTraceLoadError(const TraceLoadError &error);		/* prints the message and exits */
+extern thread_local bool traceLoadDeferred;
+
+#endif /* TRACEFILE_H_ */
@@ -0,0 +1,123 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <omp.h>
+#include <iostream>
+#include <stdlib.h>
+#include "TracePrefetch.h"
+
+using namespace std;
+
+TracePrefetch::TracePrefetch(const vector<string> &_weightfile, const vector<string> &_inputfile, const vector<bool> &_streamed):
+waitTime(0), weightfile(_weightfile), inputfile(_inputfile), streamed(_streamed), numLoaded(0), current(-1), failedLayer(-1), stop(false), config(param) {
+	loader = thread(&TracePrefetch::Run, this);
+}
+
+TracePrefetch::~TracePrefetch() {
+	{
+		unique_lock<mutex> guard(lock);
+		stop = true;
+	}
+	changed.notify_all();
+	loader.join();
+	FreeLayerTraces(&slot[0]);
+	FreeLayerTraces(&slot[1]);
+}
+
+void TracePrefetch::Run() {
+	param = config;
+	traceLoadDeferred = true;	// errors are reported by Get on the main thread
+	for (int i=0; i<(int) weightfile.size(); i++) {
+		{
+			// slot[i%2] is free once layer i-1 is taken, i.e. layer i-2 is done
+			unique_lock<mutex> guard(lock);
+			while (!stop && i > current+1) {
+				changed.wait(guard);
+			}
+			if (stop) {
+				return;
+			}
+		}
+		bool failed = false;
+		try {
+			LoadLayerTraces(weightfile[i], inputfile[i], streamed[i], &slot[i%2]);
+		} catch (const TraceLoadError &error) {
+			failure = error;
+			failed = true;
+		}
+		{
+			unique_lock<mutex> guard(lock);
+			numLoaded = i+1;
+			failedLayer = failed? i : -1;
+		}
+		changed.notify_all();
+		if (failed) {
+			return;
+		}
+	}
+}
+
+const LayerTraces &TracePrefetch::Get(int layerNumber, const string &weightfile, const string &inputfile) {
+	if (layerNumber == current) {
+		return slot[current%2];
+	}
+	if (layerNumber != current+1 || layerNumber >= (int) this->weightfile.size() || weightfile != this->weightfile[layerNumber] || inputfile != this->inputfile[layerNumber]) {
+		cout << "ERROR!: layer " << layerNumber+1 << " is not the next layer of the trace prefetch" << endl;
+		exit(-1);
+	}
+	double start = omp_get_wtime();
+	{
+		unique_lock<mutex> guard(lock);
+		while (numLoaded <= layerNumber) {
+			changed.wait(guard);
+		}
+	}
+	waitTime += omp_get_wtime() - start;
+	if (layerNumber == failedLayer) {
+		ReportTraceLoadError(failure);
+	}
+	if (current >= 0) {
+		FreeLayerTraces(&slot[current%2]);		// the loader only fills this slot after current is advanced
+	}
+	{
+		unique_lock<mutex> guard(lock);
+		current = layerNumber;
+	}
+	changed.notify_all();
+	return slot[current%2];
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef TRACEPREFETCH_H_
+#define TRACEPREFETCH_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "InputParameter.h"
+#include "Technology.h"
+#include "MemCell.h"
+#include "Param.h"
+#include "Chip.h"
+#include "TraceFile.h"
+
+using namespace std;
+
+/* Background loader of the layer traces (param->tracePrefetch): while layer i is simulated, the weight and input traces
+   of layer i+1 are loaded, parsed and mapped by a second thread, so at most two layers are in memory at a time.
+   Layers are taken in order, and a layer can be taken again until the next one is (fast estimate calibration) */
+class TracePrefetch {
+public:
+	TracePrefetch(const vector<string> &_weightfile, const vector<string> &_inputfile, const vector<bool> &_streamed);
+	virtual ~TracePrefetch();
+
+	/* Functions */
+	const LayerTraces &Get(int layerNumber, const string &weightfile, const string &inputfile);	/* waits until the layer is loaded, frees the previous one; a load error of the layer is reported here */
+
+	/* Properties */
+	double waitTime;	/* Unit: s, time spent in Get waiting for the loader */
+
+private:
+	void Run();
+
+	vector<string> weightfile, inputfile;
+	vector<bool> streamed;
+	LayerTraces slot[2];	/* layer i is loaded into slot[i%2] */
+	int numLoaded;			/* layers 0 .. numLoaded-1 are loaded */
+	int current;			/* layer taken by Get, -1 before the first one */
+	int failedLayer;		/* layer the loader stopped at with failure, -1 if none */
+	TraceLoadError failure;
+	bool stop;
+	Param *config;			/* param of the constructing thread, bound to the loader */
+	mutex lock;
+	condition_variable changed;
+	thread loader;
+};
+
+#endif /* TRACEPREFETCH_H_ */
@@ -0,0 +1,195 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <omp.h>
+#include <iostream>
+#include <sstream>
+#include "Param.h"
+#include "WeightCache.h"
+
+using namespace std;
+
+extern Param *param;
+
+atomic<int> weightCacheHits(0);
+atomic<int> weightCacheMisses(0);
+
+static const char weightCacheMagic[8] = "NSWCACH";
+
+/* 64-bit FNV-1a over 8-byte words, then the remaining bytes */
+static uint64_t ContentHash(const unsigned char *data, size_t size, uint64_t hash) {
+	const uint64_t prime = 0x100000001b3ULL;
+	size_t i = 0;
+	for (; i+8<=size; i+=8) {
+		uint64_t word;
+		memcpy(&word, data+i, 8);
+		hash = (hash ^ word) * prime;
+	}
+	for (; i<size; i++) {
+		hash = (hash ^ data[i]) * prime;
+	}
+	return hash;
+}
+
+static string WeightCacheFile(const WeightCacheKey &key) {
+	uint64_t name = ContentHash((const unsigned char *) &key, sizeof(key), 0xcbf29ce484222325ULL);
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) name);
+	return param->weightCacheDir + "/" + hex + ".nsw";
+}
+
+bool GetWeightCacheKey(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance, WeightCacheKey *key) {
+	memset(key, 0, sizeof(*key));		// no uninitialized padding in the hashed and compared bytes
+	int fd = open(weightfile.c_str(), O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0 || S_ISDIR(status.st_mode)) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return false;
+	}
+	key->contentSize = status.st_size;
+	key->contentHash = 0xcbf29ce484222325ULL;
+	if (status.st_size > 0) {
+		void *data = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			return false;
+		}
+		key->contentHash = ContentHash((const unsigned char *) data, status.st_size, key->contentHash);
+		munmap(data, status.st_size);
+	}
+	close(fd);
+	key->algoWeightMax = param->algoWeightMax;
+	key->algoWeightMin = param->algoWeightMin;
+	key->maxConductance = maxConductance;
+	key->minConductance = minConductance;
+	key->synapseBit = param->synapseBit;
+	key->cellBit = param->cellBit;
+	key->numRowPerSynapse = numRowPerSynapse;
+	key->numColPerSynapse = numColPerSynapse;
+	key->BNNparallelMode = param->BNNparallelMode;
+	key->xnorMode = param->XNORparallelMode || param->XNORsequentialMode;
+	return true;
+}
+
+bool ReadWeightCache(const WeightCacheKey &key, LevelMatrix *weight) {
+	string filename = WeightCacheFile(key);
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0 || status.st_size < (off_t) sizeof(WeightCacheHeader)) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		weightCacheMisses++;
+		return false;
+	}
+	void *data = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		weightCacheMisses++;
+		return false;
+	}
+	const unsigned char *mapping = (const unsigned char *) data;
+	WeightCacheHeader header;
+	memcpy(&header, mapping, sizeof(header));
+	bool valid = memcmp(header.magic, weightCacheMagic, sizeof(header.magic)) == 0 && header.version == weightCacheVersion
+				&& memcmp(&header.key, &key, sizeof(key)) == 0 && header.numRow >= 0 && header.numCol >= 0 && header.numLevel >= 0
+				&& status.st_size == (off_t) (sizeof(header) + header.numLevel*sizeof(double) + (size_t) header.numRow*header.numCol);
+	if (valid) {
+		LevelMatrix cached(header.numRow, header.numCol, LevelMatrix::rowMajor);
+		cached.complementRows = header.complementRows;
+		cached.levelValue.resize(header.numLevel);
+		memcpy(&cached.levelValue[0], mapping + sizeof(header), header.numLevel*sizeof(double));
+		// the rows are copied into the padded, aligned layout of LevelMatrix
+		const unsigned char *level = mapping + sizeof(header) + header.numLevel*sizeof(double);
+		for (int row=0; row<header.numRow && header.numCol>0; row++) {
+			memcpy(&cached(row, 0), level + (size_t) row*header.numCol, header.numCol);
+		}
+		*weight = cached;
+	}
+	munmap(data, status.st_size);
+	if (valid) {
+		weightCacheHits++;
+	} else {
+		weightCacheMisses++;
+	}
+	return valid;
+}
+
+void WriteWeightCache(const WeightCacheKey &key, const LevelMatrix &weight) {
+	string filename = WeightCacheFile(key);
+	mkdir(param->weightCacheDir.c_str(), 0777);
+	// written under a temporary name and renamed, so that concurrent simulations (and layers, param->concurrentLayers) never read a partial entry
+	ostringstream temporary;
+	temporary << filename << ".tmp" << getpid() << "." << omp_get_thread_num();
+	FILE *file = fopen(temporary.str().c_str(), "wb");
+	if (file == NULL) {
+		cout << "Warning: the weight cache " << param->weightCacheDir << " cannot be written (" << strerror(errno) << ")!" << endl;
+		return;
+	}
+	WeightCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, weightCacheMagic, sizeof(header.magic));
+	header.version = weightCacheVersion;
+	header.complementRows = weight.complementRows;
+	header.numRow = weight.numRow;
+	header.numCol = weight.numCol;
+	header.numLevel = weight.levelValue.size();
+	header.key = key;
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (written && header.numLevel > 0) {
+		written = fwrite(&weight.levelValue[0], sizeof(double), header.numLevel, file) == (size_t) header.numLevel;
+	}
+	for (int row=0; written && row<weight.numRow && weight.numCol>0; row++) {
+		written = fwrite(&weight.data[(long) row*weight.rowStep], 1, weight.numCol, file) == (size_t) weight.numCol;
+	}
+	written = (fclose(file) == 0) && written;
+	if (!written || rename(temporary.str().c_str(), filename.c_str()) != 0) {
+		cout << "Warning: the weight cache entry " << filename << " cannot be written (" << strerror(errno) << ")!" << endl;
+		unlink(temporary.str().c_str());
+	}
+}
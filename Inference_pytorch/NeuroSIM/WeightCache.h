@@ -0,0 +1,81 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+*   
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+*   
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer. 
+*   
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen     Email: pchen72 at asu dot edu 
+*                     
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef WEIGHTCACHE_H_
+#define WEIGHTCACHE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include "Matrix.h"
+
+using namespace std;
+
+/* Persistent cache of the mapped weight matrices (param->weightCacheDir). LoadInWeightData keeps the cell level indices
+   of a weight trace in <weightCacheDir>/<16 hex digits>.nsw, named by the hash of the key below: a changed trace or
+   mapping setting gives another file, so a stale entry is never read. The key is also stored and compared on reading */
+struct WeightCacheKey {
+	uint64_t contentHash;		/* of the whole weight trace file */
+	uint64_t contentSize;		/* Unit: byte */
+	double algoWeightMax, algoWeightMin;
+	double maxConductance, minConductance;
+	int32_t synapseBit, cellBit;
+	int32_t numRowPerSynapse, numColPerSynapse;
+	int32_t BNNparallelMode, xnorMode;
+};
+
+/* File header (64 bytes + key), followed by numLevel doubles (levelValue) and numRow x numCol level indices in row-major order */
+struct WeightCacheHeader {
+	char magic[8];			/* "NSWCACH" */
+	uint32_t version;		/* weightCacheVersion */
+	uint32_t complementRows;
+	int32_t numRow, numCol;
+	int32_t numLevel;
+	uint8_t reserved[36];
+	WeightCacheKey key;
+};
+
+const uint32_t weightCacheVersion = 1;
+
+bool GetWeightCacheKey(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance, WeightCacheKey *key);	/* false if the trace cannot be read */
+bool ReadWeightCache(const WeightCacheKey &key, LevelMatrix *weight);		/* false on a cache miss, counts the hits and misses */
+void WriteWeightCache(const WeightCacheKey &key, const LevelMatrix &weight);
+
+extern atomic<int> weightCacheHits, weightCacheMisses;		/* updated by the loading threads (layer tasks, TracePrefetch loader) */
+
+#endif /* WEIGHTCACHE_H_ */
@@ -0,0 +1,72 @@
+#!/bin/bash
+################################################################################
+# Copyright (c) 2015-2017
+# School of Electrical, Computer and Energy Engineering, Arizona State University
+# PI: Prof. Shimeng Yu
+# All rights reserved.
+# 
+# This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+# neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+# Copyright of the model is maintained by the developers, and the model is distributed under 
+# the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+# http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+# The source code is free and you can redistribute and/or modify it
+# by providing that the following conditions are met:
+# 
+#  1) Redistributions of source code must retain the above copyright notice,
+#     this list of conditions and the following disclaimer.
+# 
+#  2) Redistributions in binary form must reproduce the above copyright notice,
+#     this list of conditions and the following disclaimer in the documentation
+#     and/or other materials provided with the distribution.
+# 
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+# 
+# Developer list: 
+#   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+#                    
+#   Xiaochen Peng   Email: xpeng15 at asu dot edu
+################################################################################
+
+# Check that the simulation results do not depend on the thread count: run the same NeuroSim command on a single thread and on
+# N threads (OMP_NUM_THREADS) and compare the whole output, the Monte Carlo statistics (param->monteCarloTrials) and the fast
+# estimate calibration included. Only the lines that are expected to differ from run to run are left out (run-time, trace
+# loading speed, weight cache hits, the thread count of param->reproducibilityCheck).
+#
+# usage: NeuroSIM/check_threads.sh N command...
+#   e.g. (from Inference_pytorch, once the traces are generated)
+#        NeuroSIM/check_threads.sh 8 $(cat layer_record/trace_command.sh)
+# exit status 0 when the outputs are identical, 1 when they differ (the differences are printed)
+
+if [ $# -lt 2 ]; then
+	echo "usage: $0 N command..."
+	exit 2
+fi
+threads=$1
+shift
+set -o pipefail
+
+output1=$(mktemp)
+outputN=$(mktemp)
+trap 'rm -f "$output1" "$outputN"' EXIT
+
+filter='Run-time|^Trace loading|^Weight cache|^Reproducibility check|differ from a single thread'
+
+OMP_NUM_THREADS=1 "$@" | grep -v -E "$filter" > "$output1" || exit 2
+OMP_NUM_THREADS=$threads "$@" | grep -v -E "$filter" > "$outputN" || exit 2
+
+if diff "$output1" "$outputN"; then
+	echo "Thread check: the results on $threads threads are identical to a single thread"
+	exit 0
+fi
+echo "ERROR!: the results on $threads threads differ from a single thread!"
+exit 1
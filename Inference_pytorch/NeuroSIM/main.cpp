@@ -47,6 +47,8 @@
 #include <sstream>
 #include <chrono>
 #include <algorithm>
+#include <string.h>
+#include <omp.h>
 #include "constant.h"
 #include "formula.h"
 #include "Param.h"
@@ -54,17 +56,38 @@
 #include "Chip.h"
 #include "ProcessingUnit.h"
 #include "SubArray.h"
+#include "ColumnKernel.h"
+#include "CsvParser.h"
+#include "TracePrefetch.h"
+#include "WeightCache.h"
+#include "SimulationContext.h"
 #include "Definition.h"
 
 using namespace std;
 
+/* results of one layer (ChipCalculatePerformance), filled in by its task */
+struct LayerPerformance {
+	double readLatency, readDynamicEnergy, leakage, bufferLatency, bufferDynamicEnergy, icLatency, icDynamicEnergy;
+	double coreLatencyADC, coreLatencyAccum, coreLatencyOther, coreEnergyADC, coreEnergyAccum, coreEnergyOther;
+	double dedupRatio;		// < 0: no input vector was simulated one by one (param->fastEstimate)
+	double sampleFraction;	// param->inputSampling: fraction of the input vectors simulated
+	string latencyInterval[4], energyInterval[4];	// total, ADC, accumulation, other
+	string fastEstimateError;
+};
+
 vector<vector<double> > getNetStructure(const string &inputfile);
+string SampleInterval(double relativeError);
+string FastEstimateError(const double *fastResult, const double *exactResult);
+bool SameLayerPerformance(const LayerPerformance &a, const LayerPerformance &b);
+string MonteCarloStatistics(vector<double> value, double scale, const string &unit);
 
 int main(int argc, char * argv[]) {   
 
 	auto start = chrono::high_resolution_clock::now();
 	
-	gen.seed(0);
+	SimulationContext ctx;
+	ctx.Bind();
+	ctx.gen.seed(0);
 	
 	vector<vector<double> > netStructure;
 	netStructure = getNetStructure(argv[1]);
@@ -108,11 +131,23 @@ int main(int argc, char * argv[]) {
 		param->numColPerSynapse = ceil((double)param->synapseBit/(double)param->cellBit); 
 	}
 	
+	if (param->tracePrefetch && param->concurrentLayers <= 1 && param->monteCarloTrials <= 0) {
+		// the first layer is already loaded during the floor plan (concurrent layers and Monte Carlo trials load their own traces)
+		vector<string> weightfile, inputfile;
+		vector<bool> streamed;
+		for (int i=0; i<netStructure.size(); i++) {
+			weightfile.push_back(argv[2*i+4]);
+			inputfile.push_back(argv[2*i+5]);
+			streamed.push_back(StreamedLayer(netStructure, i));
+		}
+		ctx.tracePrefetch = new TracePrefetch(weightfile, inputfile, streamed);
+	}
+	
 	double maxPESizeNM, maxTileSizeCM, numPENM;
 	vector<int> markNM;
 	vector<int> pipelineSpeedUp;
-	markNM = ChipDesignInitialize(inputParameter, tech, cell, false, netStructure, &maxPESizeNM, &maxTileSizeCM, &numPENM);
-	pipelineSpeedUp = ChipDesignInitialize(inputParameter, tech, cell, true, netStructure, &maxPESizeNM, &maxTileSizeCM, &numPENM);
+	markNM = ChipDesignInitialize(ctx, ctx.inputParameter, ctx.tech, ctx.cell, false, netStructure, &maxPESizeNM, &maxTileSizeCM, &numPENM);
+	pipelineSpeedUp = ChipDesignInitialize(ctx, ctx.inputParameter, ctx.tech, ctx.cell, true, netStructure, &maxPESizeNM, &maxTileSizeCM, &numPENM);
 	
 	double desiredNumTileNM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM;
 	int numTileRow, numTileCol;
@@ -185,7 +220,7 @@ int main(int argc, char * argv[]) {
 	}
 	
 	
-	ChipInitialize(inputParameter, tech, cell, netStructure, markNM, numTileEachLayer,
+	ChipInitialize(ctx, ctx.inputParameter, ctx.tech, ctx.cell, netStructure, markNM, numTileEachLayer,
 					numPENM, desiredNumTileNM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM, numTileRow, numTileCol);
 					
 	double chipHeight, chipWidth, chipArea, chipAreaIC, chipAreaADC, chipAreaAccum, chipAreaOther;
@@ -195,7 +230,7 @@ int main(int argc, char * argv[]) {
 	double NMTilewidth = 0;
 	vector<double> chipAreaResults;
 						
-	chipAreaResults = ChipCalculateArea(inputParameter, tech, cell, desiredNumTileNM, numPENM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM, numTileRow, 
+	chipAreaResults = ChipCalculateArea(ctx, ctx.inputParameter, ctx.tech, ctx.cell, desiredNumTileNM, numPENM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM, numTileRow, 
 					&chipHeight, &chipWidth, &CMTileheight, &CMTilewidth, &NMTileheight, &NMTilewidth);		
 	chipArea = chipAreaResults[0];
 	chipAreaIC = chipAreaResults[1];
@@ -219,171 +254,235 @@ int main(int argc, char * argv[]) {
 	double chipEnergyAccum = 0;
 	double chipEnergyOther = 0;
 	
-	double layerReadLatency = 0;
-	double layerReadDynamicEnergy = 0;
-	double tileLeakage = 0;
-	double layerbufferLatency = 0;
-	double layerbufferDynamicEnergy = 0;
-	double layericLatency = 0;
-	double layericDynamicEnergy = 0;
-	
-	double coreLatencyADC = 0;
-	double coreLatencyAccum = 0;
-	double coreLatencyOther = 0;
-	double coreEnergyADC = 0;
-	double coreEnergyAccum = 0;
-	double coreEnergyOther = 0;
+	// with param->concurrentLayers > 1, the layers take turns on that many chips, the extra ones built like ctx above
+	// (the circuit modules keep the state of the layer being simulated, so two layers cannot share one).
+	// The Monte Carlo trials are independent as well, with param->monteCarloTrials > 0 there is at least one chip per thread of the team
+	int numChip = param->concurrentLayers;
+	if (param->monteCarloTrials > 0) {
+		numChip = max(numChip, omp_get_max_threads());
+	}
+	vector<SimulationContext *> layerContext(1, &ctx);
+	while (layerContext.size() < min(numChip, (int) netStructure.size()*(1+max(param->monteCarloTrials, 0)))) {
+		SimulationContext *layerCtx = new SimulationContext;
+		layerCtx->config = ctx.config;
+		ParamBinding binding(*layerCtx);
+		double layerMaxPESizeNM = 0, layerMaxTileSizeCM = 0, layerNumPENM = 0, layerChipSize[6];
+		ChipDesignInitialize(*layerCtx, layerCtx->inputParameter, layerCtx->tech, layerCtx->cell, false, netStructure, &layerMaxPESizeNM, &layerMaxTileSizeCM, &layerNumPENM);
+		ChipInitialize(*layerCtx, layerCtx->inputParameter, layerCtx->tech, layerCtx->cell, netStructure, markNM, numTileEachLayer,
+						numPENM, desiredNumTileNM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM, numTileRow, numTileCol);
+		ChipCalculateArea(*layerCtx, layerCtx->inputParameter, layerCtx->tech, layerCtx->cell, desiredNumTileNM, numPENM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM, numTileRow, 
+						&layerChipSize[0], &layerChipSize[1], &layerChipSize[2], &layerChipSize[3], &layerChipSize[4], &layerChipSize[5]);
+		layerContext.push_back(layerCtx);
+	}
 	
+	vector<LayerPerformance> layerPerformance(netStructure.size()), monteCarloPerformance(max(param->monteCarloTrials, 0)*netStructure.size()+1);
+	LayerPerformance *performance = &layerPerformance[0], *trialPerformance = &monteCarloPerformance[0];
+	int reportOrder = 0;
 	
 	cout << "-------------------------------------- Hardware Performance --------------------------------------" <<  endl;
 	
-	if (! param->pipeline) {
-		// layer-by-layer process
-		// show the detailed hardware performance for each layer
+	// one task per layer, chained on the chip it runs on (layers on different chips, param->concurrentLayers, run at the same time).
+	// Inside a layer the tiles and PEs are simulated one after the other, only the subArrays of each PE are shared out to the team
+	// (a taskloop that the layer task waits for, see ProcessingUnitCalculatePerformance), then the PE, tile and layer results are combined in order.
+	// The layer-by-layer report of each layer is a task that waits for that layer and the previous report
+	#pragma omp parallel copyin(param)
+	#pragma omp single
+	{
 		for (int i=0; i<netStructure.size(); i++) {
-			cout << "-------------------- Estimation of Layer " << i+1 << " ----------------------" << endl;
-			
-			ChipCalculatePerformance(inputParameter, tech, cell, i, argv[2*i+4], argv[2*i+4], argv[2*i+5], netStructure[i][6],
-						netStructure, markNM, numTileEachLayer, utilizationEachLayer, speedUpEachLayer, tileLocaEachLayer,
-						numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth,
-						&layerReadLatency, &layerReadDynamicEnergy, &tileLeakage, &layerbufferLatency, &layerbufferDynamicEnergy, &layericLatency, &layericDynamicEnergy,
-						&coreLatencyADC, &coreLatencyAccum, &coreLatencyOther, &coreEnergyADC, &coreEnergyAccum, &coreEnergyOther);
+			SimulationContext *layerCtx = layerContext[i % layerContext.size()];
+			#pragma omp task depend(inout: layerCtx[0:1]) depend(out: performance[i:1])
+			{
+				ParamBinding binding(*layerCtx);
+				LayerPerformance &p = performance[i];
+				double fastResult[8];
+				if (param->fastEstimateCalibration) {
+					// fast estimate first, the exact results below are reported and used as the reference
+					param->fastEstimate = true;
+					ChipCalculatePerformance(*layerCtx, layerCtx->inputParameter, layerCtx->tech, layerCtx->cell, i, argv[2*i+4], argv[2*i+4], argv[2*i+5], netStructure[i][6],
+								netStructure, markNM, numTileEachLayer, utilizationEachLayer, speedUpEachLayer, tileLocaEachLayer,
+								numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth,
+								&p.readLatency, &p.readDynamicEnergy, &p.leakage, &p.bufferLatency, &p.bufferDynamicEnergy, &p.icLatency, &p.icDynamicEnergy,
+								&p.coreLatencyADC, &p.coreLatencyAccum, &p.coreLatencyOther, &p.coreEnergyADC, &p.coreEnergyAccum, &p.coreEnergyOther);
+					param->fastEstimate = false;
+					double layerResult[8] = {p.readLatency, p.readDynamicEnergy, p.coreLatencyADC, p.coreLatencyAccum, p.coreLatencyOther, p.coreEnergyADC, p.coreEnergyAccum, p.coreEnergyOther};
+					copy(layerResult, layerResult+8, fastResult);
+				}
+				layerCtx->numInputVectorTotal = 0;
+				layerCtx->numInputVectorSimulated = 0;
+				layerCtx->numInputPattern = 0;
+				layerCtx->inputSampleLatencyError.assign(4, 0);
+				layerCtx->inputSampleEnergy.assign(4, 0);
+				layerCtx->inputSampleEnergyVariance.assign(4, 0);
+				ChipCalculatePerformance(*layerCtx, layerCtx->inputParameter, layerCtx->tech, layerCtx->cell, i, argv[2*i+4], argv[2*i+4], argv[2*i+5], netStructure[i][6],
+							netStructure, markNM, numTileEachLayer, utilizationEachLayer, speedUpEachLayer, tileLocaEachLayer,
+							numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth,
+							&p.readLatency, &p.readDynamicEnergy, &p.leakage, &p.bufferLatency, &p.bufferDynamicEnergy, &p.icLatency, &p.icDynamicEnergy,
+							&p.coreLatencyADC, &p.coreLatencyAccum, &p.coreLatencyOther, &p.coreEnergyADC, &p.coreEnergyAccum, &p.coreEnergyOther);
+				double exactResult[8] = {p.readLatency, p.readDynamicEnergy, p.coreLatencyADC, p.coreLatencyAccum, p.coreLatencyOther, p.coreEnergyADC, p.coreEnergyAccum, p.coreEnergyOther};
 			
-			double numTileOtherLayer = 0;
-			double layerLeakageEnergy = 0;		
-			for (int j=0; j<netStructure.size(); j++) {
-				if (j != i) {
-					numTileOtherLayer += numTileEachLayer[0][j] * numTileEachLayer[1][j];
+				for (int m=0; m<4; m++) {
+					p.latencyInterval[m] = SampleInterval(1.96*layerCtx->inputSampleLatencyError[m]);
+					p.energyInterval[m] = SampleInterval(layerCtx->inputSampleEnergy[m] > 0? 1.96*sqrt(layerCtx->inputSampleEnergyVariance[m])/layerCtx->inputSampleEnergy[m] : 0);
+				}
+				p.dedupRatio = layerCtx->numInputVectorSimulated > 0? 1-layerCtx->numInputPattern/layerCtx->numInputVectorSimulated : -1;
+				p.sampleFraction = layerCtx->numInputVectorTotal > 0? layerCtx->numInputVectorSimulated/layerCtx->numInputVectorTotal : 0;
+				p.fastEstimateError = param->fastEstimateCalibration? FastEstimateError(fastResult, exactResult) : "";
+			}
+		
+			if (! param->pipeline) {
+				// layer-by-layer process
+				// show the detailed hardware performance for each layer
+				#pragma omp task depend(in: performance[i:1]) depend(inout: reportOrder)
+				{
+					const LayerPerformance &p = performance[i];
+					cout << "-------------------- Estimation of Layer " << i+1 << " ----------------------" << endl;
+				
+					double numTileOtherLayer = 0;
+					double layerLeakageEnergy = 0;		
+					for (int j=0; j<netStructure.size(); j++) {
+						if (j != i) {
+							numTileOtherLayer += numTileEachLayer[0][j] * numTileEachLayer[1][j];
+						}
+					}
+					layerLeakageEnergy = numTileOtherLayer*p.readLatency*p.leakage;
+				
+					cout << "layer" << i+1 << "'s readLatency is: " << p.readLatency*1e9 << "ns" << p.latencyInterval[0] << endl;
+					cout << "layer" << i+1 << "'s readDynamicEnergy is: " << p.readDynamicEnergy*1e12 << "pJ" << p.energyInterval[0] << endl;
+					cout << "layer" << i+1 << "'s leakagePower is: " << numTileEachLayer[0][i] * numTileEachLayer[1][i] * p.leakage*1e6 << "uW" << endl;
+					cout << "layer" << i+1 << "'s leakageEnergy is: " << layerLeakageEnergy*1e12 << "pJ" << endl;
+					cout << "layer" << i+1 << "'s buffer latency is: " << p.bufferLatency*1e9 << "ns" << endl;
+					cout << "layer" << i+1 << "'s buffer readDynamicEnergy is: " << p.bufferDynamicEnergy*1e12 << "pJ" << endl;
+					cout << "layer" << i+1 << "'s ic latency is: " << p.icLatency*1e9 << "ns" << endl;
+					cout << "layer" << i+1 << "'s ic readDynamicEnergy is: " << p.icDynamicEnergy*1e12 << "pJ" << endl;
+					if (p.dedupRatio >= 0) {
+						cout << "layer" << i+1 << "'s input vector dedup ratio is: " << p.dedupRatio*100 << "%" << endl;
+					}
+					if (param->inputSampling) {
+						cout << "layer" << i+1 << "'s input vector sampling fraction is: " << p.sampleFraction*100 << "%" << endl;
+					}
+					if (param->fastEstimateCalibration) {
+						cout << "layer" << i+1 << "'s fast estimate relative error is: " << p.fastEstimateError << endl;
+					}
+				
+				
+					cout << endl;
+					cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
+					cout << endl;
+					cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << p.coreLatencyADC*1e9 << "ns" << p.latencyInterval[1] << endl;
+					cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << p.coreLatencyAccum*1e9 << "ns" << p.latencyInterval[2] << endl;
+					cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << p.coreLatencyOther*1e9 << "ns" << p.latencyInterval[3] << endl;
+					cout << "----------- ADC (or S/As and precharger for SRAM) readDynamicEnergy is : " << p.coreEnergyADC*1e12 << "pJ" << p.energyInterval[1] << endl;
+					cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readDynamicEnergy is : " << p.coreEnergyAccum*1e12 << "pJ" << p.energyInterval[2] << endl;
+					cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readDynamicEnergy is : " << p.coreEnergyOther*1e12 << "pJ" << p.energyInterval[3] << endl;
+					cout << endl;
+					cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
+					cout << endl;
+				
+					chipReadLatency += p.readLatency;
+					chipReadDynamicEnergy += p.readDynamicEnergy;
+					chipLeakageEnergy += layerLeakageEnergy;
+					chipLeakage += p.leakage*numTileEachLayer[0][i] * numTileEachLayer[1][i];
+					chipbufferLatency += p.bufferLatency;
+					chipbufferReadDynamicEnergy += p.bufferDynamicEnergy;
+					chipicLatency += p.icLatency;
+					chipicReadDynamicEnergy += p.icDynamicEnergy;
+				
+					chipLatencyADC += p.coreLatencyADC;
+					chipLatencyAccum += p.coreLatencyAccum;
+					chipLatencyOther += p.coreLatencyOther;
+					chipEnergyADC += p.coreEnergyADC;
+					chipEnergyAccum += p.coreEnergyAccum;
+					chipEnergyOther += p.coreEnergyOther;
 				}
 			}
-			layerLeakageEnergy = numTileOtherLayer*layerReadLatency*tileLeakage;
-			
-			cout << "layer" << i+1 << "'s readLatency is: " << layerReadLatency*1e9 << "ns" << endl;
-			cout << "layer" << i+1 << "'s readDynamicEnergy is: " << layerReadDynamicEnergy*1e12 << "pJ" << endl;
-			cout << "layer" << i+1 << "'s leakagePower is: " << numTileEachLayer[0][i] * numTileEachLayer[1][i] * tileLeakage*1e6 << "uW" << endl;
-			cout << "layer" << i+1 << "'s leakageEnergy is: " << layerLeakageEnergy*1e12 << "pJ" << endl;
-			cout << "layer" << i+1 << "'s buffer latency is: " << layerbufferLatency*1e9 << "ns" << endl;
-			cout << "layer" << i+1 << "'s buffer readDynamicEnergy is: " << layerbufferDynamicEnergy*1e12 << "pJ" << endl;
-			cout << "layer" << i+1 << "'s ic latency is: " << layericLatency*1e9 << "ns" << endl;
-			cout << "layer" << i+1 << "'s ic readDynamicEnergy is: " << layericDynamicEnergy*1e12 << "pJ" << endl;
-			
-			
-			cout << endl;
-			cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
-			cout << endl;
-			cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << coreLatencyADC*1e9 << "ns" << endl;
-			cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << coreLatencyAccum*1e9 << "ns" << endl;
-			cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << coreLatencyOther*1e9 << "ns" << endl;
-			cout << "----------- ADC (or S/As and precharger for SRAM) readDynamicEnergy is : " << coreEnergyADC*1e12 << "pJ" << endl;
-			cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readDynamicEnergy is : " << coreEnergyAccum*1e12 << "pJ" << endl;
-			cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readDynamicEnergy is : " << coreEnergyOther*1e12 << "pJ" << endl;
-			cout << endl;
-			cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
-			cout << endl;
-			
-			chipReadLatency += layerReadLatency;
-			chipReadDynamicEnergy += layerReadDynamicEnergy;
-			chipLeakageEnergy += layerLeakageEnergy;
-			chipLeakage += tileLeakage*numTileEachLayer[0][i] * numTileEachLayer[1][i];
-			chipbufferLatency += layerbufferLatency;
-			chipbufferReadDynamicEnergy += layerbufferDynamicEnergy;
-			chipicLatency += layericLatency;
-			chipicReadDynamicEnergy += layericDynamicEnergy;
-			
-			chipLatencyADC += coreLatencyADC;
-			chipLatencyAccum += coreLatencyAccum;
-			chipLatencyOther += coreLatencyOther;
-			chipEnergyADC += coreEnergyADC;
-			chipEnergyAccum += coreEnergyAccum;
-			chipEnergyOther += coreEnergyOther;
 		}
-	} else {
+		
+		// Monte Carlo trials (param->monteCarloTrials): the layers again with device variation, queued after the nominal ones on the same chips
+		for (int t=0; t<param->monteCarloTrials; t++) {
+			for (int i=0; i<netStructure.size(); i++) {
+				int n = t*netStructure.size() + i;
+				SimulationContext *layerCtx = layerContext[(netStructure.size() + n) % layerContext.size()];
+				#pragma omp task depend(inout: layerCtx[0:1]) depend(out: trialPerformance[n:1])
+				{
+					ParamBinding binding(*layerCtx);
+					layerCtx->variationTrial = t;
+					layerCtx->variationLayer = i;
+					LayerPerformance &p = trialPerformance[n];
+					ChipCalculatePerformance(*layerCtx, layerCtx->inputParameter, layerCtx->tech, layerCtx->cell, i, argv[2*i+4], argv[2*i+4], argv[2*i+5], netStructure[i][6],
+								netStructure, markNM, numTileEachLayer, utilizationEachLayer, speedUpEachLayer, tileLocaEachLayer,
+								numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth,
+								&p.readLatency, &p.readDynamicEnergy, &p.leakage, &p.bufferLatency, &p.bufferDynamicEnergy, &p.icLatency, &p.icDynamicEnergy,
+								&p.coreLatencyADC, &p.coreLatencyAccum, &p.coreLatencyOther, &p.coreEnergyADC, &p.coreEnergyAccum, &p.coreEnergyOther);
+					layerCtx->variationTrial = -1;
+				}
+			}
+		}
+	}
+	
+	for (int k=1; k<layerContext.size(); k++) {
+		delete layerContext[k];
+	}
+	
+	if (param->pipeline) {
 		// pipeline system
 		// firstly define system clock
 		double systemClock = 0;
-		
-		vector<double> readLatencyPerLayer;
-		vector<double> readDynamicEnergyPerLayer;
-		vector<double> leakagePowerPerLayer;
-		vector<double> bufferLatencyPerLayer;
-		vector<double> bufferEnergyPerLayer;
-		vector<double> icLatencyPerLayer;
-		vector<double> icEnergyPerLayer;
-		
-		vector<double> coreLatencyADCPerLayer;
-		vector<double> coreEnergyADCPerLayer;
-		vector<double> coreLatencyAccumPerLayer;
-		vector<double> coreEnergyAccumPerLayer;
-		vector<double> coreLatencyOtherPerLayer;
-		vector<double> coreEnergyOtherPerLayer;
-		
 		for (int i=0; i<netStructure.size(); i++) {
-			ChipCalculatePerformance(inputParameter, tech, cell, i, argv[2*i+4], argv[2*i+4], argv[2*i+5], netStructure[i][6],
-						netStructure, markNM, numTileEachLayer, utilizationEachLayer, speedUpEachLayer, tileLocaEachLayer,
-						numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth,
-						&layerReadLatency, &layerReadDynamicEnergy, &tileLeakage, &layerbufferLatency, &layerbufferDynamicEnergy, &layericLatency, &layericDynamicEnergy,
-						&coreLatencyADC, &coreLatencyAccum, &coreLatencyOther, &coreEnergyADC, &coreEnergyAccum, &coreEnergyOther);
-						
-			
-			systemClock = MAX(systemClock, layerReadLatency);
-			
-			readLatencyPerLayer.push_back(layerReadLatency);
-			readDynamicEnergyPerLayer.push_back(layerReadDynamicEnergy);
-			leakagePowerPerLayer.push_back(numTileEachLayer[0][i] * numTileEachLayer[1][i] * tileLeakage);
-			bufferLatencyPerLayer.push_back(layerbufferLatency);
-			bufferEnergyPerLayer.push_back(layerbufferDynamicEnergy);
-			icLatencyPerLayer.push_back(layericLatency);
-			icEnergyPerLayer.push_back(layericDynamicEnergy);
-			
-			coreLatencyADCPerLayer.push_back(coreLatencyADC);
-			coreEnergyADCPerLayer.push_back(coreEnergyADC);
-			coreLatencyAccumPerLayer.push_back(coreLatencyAccum);
-			coreEnergyAccumPerLayer.push_back(coreEnergyAccum);
-			coreLatencyOtherPerLayer.push_back(coreLatencyOther);
-			coreEnergyOtherPerLayer.push_back(coreEnergyOther);
+			systemClock = MAX(systemClock, layerPerformance[i].readLatency);
 		}
 		
 		for (int i=0; i<netStructure.size(); i++) {
+			const LayerPerformance &p = layerPerformance[i];
+			double leakagePower = numTileEachLayer[0][i] * numTileEachLayer[1][i] * p.leakage;
 			
 			cout << "-------------------- Estimation of Layer " << i+1 << " ----------------------" << endl;
 
-			cout << "layer" << i+1 << "'s readLatency is: " << readLatencyPerLayer[i]*1e9 << "ns" << endl;
-			cout << "layer" << i+1 << "'s readDynamicEnergy is: " << readDynamicEnergyPerLayer[i]*1e12 << "pJ" << endl;
-			cout << "layer" << i+1 << "'s leakagePower is: " << leakagePowerPerLayer[i]*1e6 << "uW" << endl;
-			cout << "layer" << i+1 << "'s leakageEnergy is: " << leakagePowerPerLayer[i] * (systemClock-readLatencyPerLayer[i]) *1e12 << "pJ" << endl;
-			cout << "layer" << i+1 << "'s buffer latency is: " << bufferLatencyPerLayer[i]*1e9 << "ns" << endl;
-			cout << "layer" << i+1 << "'s buffer readDynamicEnergy is: " << bufferEnergyPerLayer[i]*1e12 << "pJ" << endl;
-			cout << "layer" << i+1 << "'s ic latency is: " << icLatencyPerLayer[i]*1e9 << "ns" << endl;
-			cout << "layer" << i+1 << "'s ic readDynamicEnergy is: " << icEnergyPerLayer[i]*1e12 << "pJ" << endl;
+			cout << "layer" << i+1 << "'s readLatency is: " << p.readLatency*1e9 << "ns" << p.latencyInterval[0] << endl;
+			cout << "layer" << i+1 << "'s readDynamicEnergy is: " << p.readDynamicEnergy*1e12 << "pJ" << p.energyInterval[0] << endl;
+			cout << "layer" << i+1 << "'s leakagePower is: " << leakagePower*1e6 << "uW" << endl;
+			cout << "layer" << i+1 << "'s leakageEnergy is: " << leakagePower * (systemClock-p.readLatency) *1e12 << "pJ" << endl;
+			cout << "layer" << i+1 << "'s buffer latency is: " << p.bufferLatency*1e9 << "ns" << endl;
+			cout << "layer" << i+1 << "'s buffer readDynamicEnergy is: " << p.bufferDynamicEnergy*1e12 << "pJ" << endl;
+			cout << "layer" << i+1 << "'s ic latency is: " << p.icLatency*1e9 << "ns" << endl;
+			cout << "layer" << i+1 << "'s ic readDynamicEnergy is: " << p.icDynamicEnergy*1e12 << "pJ" << endl;
+			if (p.dedupRatio >= 0) {
+				cout << "layer" << i+1 << "'s input vector dedup ratio is: " << p.dedupRatio*100 << "%" << endl;
+			}
+			if (param->inputSampling) {
+				cout << "layer" << i+1 << "'s input vector sampling fraction is: " << p.sampleFraction*100 << "%" << endl;
+			}
+			if (param->fastEstimateCalibration) {
+				cout << "layer" << i+1 << "'s fast estimate relative error is: " << p.fastEstimateError << endl;
+			}
 
 			cout << endl;
 			cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
 			cout << endl;
-			cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << coreLatencyADCPerLayer[i]*1e9 << "ns" << endl;
-			cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << coreLatencyAccumPerLayer[i]*1e9 << "ns" << endl;
-			cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << coreLatencyOtherPerLayer[i]*1e9 << "ns" << endl;
-			cout << "----------- ADC (or S/As and precharger for SRAM) readDynamicEnergy is : " << coreEnergyADCPerLayer[i]*1e12 << "pJ" << endl;
-			cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readDynamicEnergy is : " << coreEnergyAccumPerLayer[i]*1e12 << "pJ" << endl;
-			cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readDynamicEnergy is : " << coreEnergyOtherPerLayer[i]*1e12 << "pJ" << endl;
+			cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << p.coreLatencyADC*1e9 << "ns" << p.latencyInterval[1] << endl;
+			cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << p.coreLatencyAccum*1e9 << "ns" << p.latencyInterval[2] << endl;
+			cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << p.coreLatencyOther*1e9 << "ns" << p.latencyInterval[3] << endl;
+			cout << "----------- ADC (or S/As and precharger for SRAM) readDynamicEnergy is : " << p.coreEnergyADC*1e12 << "pJ" << p.energyInterval[1] << endl;
+			cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readDynamicEnergy is : " << p.coreEnergyAccum*1e12 << "pJ" << p.energyInterval[2] << endl;
+			cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readDynamicEnergy is : " << p.coreEnergyOther*1e12 << "pJ" << p.energyInterval[3] << endl;
 			cout << endl;
 			cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
 			cout << endl;
 			
 			chipReadLatency = systemClock;
-			chipReadDynamicEnergy += readDynamicEnergyPerLayer[i];
-			chipLeakageEnergy += leakagePowerPerLayer[i] * (systemClock-readLatencyPerLayer[i]);
-			chipLeakage += leakagePowerPerLayer[i];
-			chipbufferLatency = MAX(chipbufferLatency, bufferLatencyPerLayer[i]);
-			chipbufferReadDynamicEnergy += bufferEnergyPerLayer[i];
-			chipicLatency = MAX(chipicLatency, icLatencyPerLayer[i]);
-			chipicReadDynamicEnergy += icEnergyPerLayer[i];
+			chipReadDynamicEnergy += p.readDynamicEnergy;
+			chipLeakageEnergy += leakagePower * (systemClock-p.readLatency);
+			chipLeakage += leakagePower;
+			chipbufferLatency = MAX(chipbufferLatency, p.bufferLatency);
+			chipbufferReadDynamicEnergy += p.bufferDynamicEnergy;
+			chipicLatency = MAX(chipicLatency, p.icLatency);
+			chipicReadDynamicEnergy += p.icDynamicEnergy;
 			
-			chipLatencyADC = MAX(chipLatencyADC, coreLatencyADCPerLayer[i]);
-			chipLatencyAccum = MAX(chipLatencyAccum, coreLatencyAccumPerLayer[i]);
-			chipLatencyOther = MAX(chipLatencyOther, coreLatencyOtherPerLayer[i]);
-			chipEnergyADC += coreEnergyADCPerLayer[i];
-			chipEnergyAccum += coreEnergyAccumPerLayer[i];
-			chipEnergyOther += coreEnergyOtherPerLayer[i];
+			chipLatencyADC = MAX(chipLatencyADC, p.coreLatencyADC);
+			chipLatencyAccum = MAX(chipLatencyAccum, p.coreLatencyAccum);
+			chipLatencyOther = MAX(chipLatencyOther, p.coreLatencyOther);
+			chipEnergyADC += p.coreEnergyADC;
+			chipEnergyAccum += p.coreEnergyAccum;
+			chipEnergyOther += p.coreEnergyOther;
 		}
 		
 	}
@@ -440,64 +539,154 @@ int main(int argc, char * argv[]) {
 		cout << "Throughput TOPS (Pipelined Process): " << numComputation/(chipReadLatency*1e12) << endl;
 		cout << "Throughput FPS (Pipelined Process): " << 1/(chipReadLatency) << endl;
 	}
+	if (param->monteCarloTrials > 0) {
+		// spread of the layer and chip results over the trials of param->monteCarloTrials, the nominal results above are without variation
+		cout << endl;
+		cout << "------------------------------ Monte Carlo Device Variation --------------------------------" <<  endl;
+		cout << param->monteCarloTrials << " trials, " << (param->variationModel == 2? "gaussian" : "lognormal") << " variation, sigma " << param->variationSigma;
+		if (param->variationSigmaLowLevel >= 0) {
+			cout << " (" << param->variationSigmaLowLevel << " at the lowest conductance level)";
+		}
+		cout << ", seed " << param->variationSeed << endl;
+		vector<double> trialLatency(param->monteCarloTrials, 0), trialEnergy(param->monteCarloTrials, 0);
+		for (int i=0; i<netStructure.size(); i++) {
+			vector<double> layerLatency, layerEnergy;
+			for (int t=0; t<param->monteCarloTrials; t++) {
+				const LayerPerformance &p = monteCarloPerformance[t*netStructure.size() + i];
+				layerLatency.push_back(p.readLatency);
+				layerEnergy.push_back(p.readDynamicEnergy);
+				trialLatency[t] = param->pipeline? MAX(trialLatency[t], p.readLatency) : trialLatency[t] + p.readLatency;
+				trialEnergy[t] += p.readDynamicEnergy;
+			}
+			cout << "layer" << i+1 << "'s readLatency " << MonteCarloStatistics(layerLatency, 1e9, "ns") << endl;
+			cout << "layer" << i+1 << "'s readDynamicEnergy " << MonteCarloStatistics(layerEnergy, 1e12, "pJ") << endl;
+		}
+		cout << (param->pipeline? "Chip pipeline-system-clock-cycle " : "Chip layer-by-layer readLatency ") << MonteCarloStatistics(trialLatency, 1e9, "ns") << endl;
+		cout << "Chip total readDynamicEnergy " << MonteCarloStatistics(trialEnergy, 1e12, "pJ") << endl;
+	}
 	cout << "-------------------------------------- Hardware Performance Done --------------------------------------" <<  endl;
 	cout << endl;
 	auto stop = chrono::high_resolution_clock::now();
 	auto duration = chrono::duration_cast<chrono::seconds>(stop-start);
     cout << "------------------------------ Simulation Performance --------------------------------" <<  endl;
 	cout << "Total Run-time of NeuroSim: " << duration.count() << " seconds" << endl;
+	if (ctx.tracePrefetch) {
+		cout << "Trace loading (overlapped with the simulation): " << csvBytesTotal/1e6 << "MB in " << csvSecondsTotal << " seconds (" << (csvSecondsTotal > 0? csvBytesTotal/1e6/csvSecondsTotal : 0) << "MB/s), " 
+			 << ctx.tracePrefetch->waitTime << " seconds waited for" << endl;
+		delete ctx.tracePrefetch;
+		ctx.tracePrefetch = NULL;
+	} else {
+		cout << "Trace loading: " << csvBytesTotal/1e6 << "MB in " << csvSecondsTotal << " seconds (" << (csvSecondsTotal > 0? csvBytesTotal/1e6/csvSecondsTotal : 0) << "MB/s)" << endl;
+	}
+	if (!param->weightCacheDir.empty()) {
+		cout << "Weight cache " << param->weightCacheDir << ": " << weightCacheHits.load() << " hits, " << weightCacheMisses.load() << " misses" << endl;
+	}
+	if (param->reproducibilityCheck) {
+		// every layer and Monte Carlo trial again on a single thread (the subArrays in order, no tasks): the reported results must be bit-identical
+		int numMismatch = 0;
+		for (int t=-1; t<param->monteCarloTrials; t++) {
+			for (int i=0; i<netStructure.size(); i++) {
+				LayerPerformance p;
+				ctx.variationTrial = t;
+				ctx.variationLayer = i;
+				ChipCalculatePerformance(ctx, ctx.inputParameter, ctx.tech, ctx.cell, i, argv[2*i+4], argv[2*i+4], argv[2*i+5], netStructure[i][6],
+							netStructure, markNM, numTileEachLayer, utilizationEachLayer, speedUpEachLayer, tileLocaEachLayer,
+							numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth,
+							&p.readLatency, &p.readDynamicEnergy, &p.leakage, &p.bufferLatency, &p.bufferDynamicEnergy, &p.icLatency, &p.icDynamicEnergy,
+							&p.coreLatencyADC, &p.coreLatencyAccum, &p.coreLatencyOther, &p.coreEnergyADC, &p.coreEnergyAccum, &p.coreEnergyOther);
+				ctx.variationTrial = -1;
+				if (!SameLayerPerformance(p, t < 0? layerPerformance[i] : monteCarloPerformance[t*netStructure.size() + i])) {
+					cout << "ERROR!: the results of layer " << i+1;
+					if (t >= 0) {
+						cout << " (Monte Carlo trial " << t+1 << ")";
+					}
+					cout << " on " << omp_get_max_threads() << " threads differ from a single thread!" << endl;
+					numMismatch++;
+				}
+			}
+		}
+		cout << "Reproducibility check (" << omp_get_max_threads() << " threads vs 1 thread): " << (numMismatch == 0? "all layers bit-identical" : "FAILED") << endl;
+	}
+	if (param->columnKernelBenchmark) {
+		ColumnKernelBenchmark();
+	}
 	cout << "------------------------------ Simulation Performance --------------------------------" <<  endl;
 	
 	return 0;
 }
 
 vector<vector<double> > getNetStructure(const string &inputfile) {
-	ifstream infile(inputfile.c_str());      
-	string inputline;
-	string inputval;
-	
-	int ROWin=0, COLin=0;      
-	if (!infile.good()) {        
+	CsvParser infile(inputfile);
+	if (!infile.good) {        
 		cerr << "Error: the input file cannot be opened!" << endl;
 		exit(1);
-	}else{
-		while (getline(infile, inputline, '\n')) {       
-			ROWin++;                                
-		}
-		infile.clear();
-		infile.seekg(0, ios::beg);      
-		if (getline(infile, inputline, '\n')) {        
-			istringstream iss (inputline);      
-			while (getline(iss, inputval, ',')) {       
-				COLin++;
-			}
-		}	
 	}
-	infile.clear();
-	infile.seekg(0, ios::beg);          
 
 	vector<vector<double> > netStructure;               
-	for (int row=0; row<ROWin; row++) {	
+	for (int row=0; row<infile.numRow; row++) {	
+		int numValue;
+		const double *rowValue = infile.Row(row, &numValue);
 		vector<double> netStructurerow;
-		getline(infile, inputline, '\n');             
-		istringstream iss;
-		iss.str(inputline);
-		for (int col=0; col<COLin; col++) {       
-			while(getline(iss, inputval, ',')){	
-				istringstream fs;
-				fs.str(inputval);
-				double f=0;
-				fs >> f;				
-				netStructurerow.push_back(f);			
-			}			
-		}		
+		if (infile.numCol > 0) {
+			netStructurerow.assign(rowValue, rowValue + numValue);
+		}
 		netStructure.push_back(netStructurerow);
 	}
-	infile.close();
 	
 	return netStructure;
-	netStructure.clear();
 }	
 
 
+string SampleInterval(double relativeError) {
+	// 95% confidence interval of a sampled result (param->inputSampling), relative to the reported value
+	if (!param->inputSampling) {
+		return "";
+	}
+	ostringstream interval;
+	interval << " (+/- " << relativeError*100 << "%, 95% CI)";
+	return interval.str();
+}
+
+
+string FastEstimateError(const double *fastResult, const double *exactResult) {
+	// relative error of the fast estimate (param->fastEstimateCalibration) for each reported metric
+	const char *metric[8] = {"readLatency", "readDynamicEnergy", "ADC readLatency", "Accumulation readLatency", "Other readLatency", 
+							"ADC readDynamicEnergy", "Accumulation readDynamicEnergy", "Other readDynamicEnergy"};
+	ostringstream error;
+	for (int m=0; m<8; m++) {
+		error << (m > 0? ", " : "") << metric[m] << " " << (exactResult[m] != 0? (fastResult[m]-exactResult[m])/exactResult[m] : 0)*100 << "%";
+	}
+	return error.str();
+}
+
+
+bool SameLayerPerformance(const LayerPerformance &a, const LayerPerformance &b) {
+	// bitwise comparison of the reported results (param->reproducibilityCheck), any difference in the summation order shows up
+	double x[13] = {a.readLatency, a.readDynamicEnergy, a.leakage, a.bufferLatency, a.bufferDynamicEnergy, a.icLatency, a.icDynamicEnergy, 
+					a.coreLatencyADC, a.coreLatencyAccum, a.coreLatencyOther, a.coreEnergyADC, a.coreEnergyAccum, a.coreEnergyOther};
+	double y[13] = {b.readLatency, b.readDynamicEnergy, b.leakage, b.bufferLatency, b.bufferDynamicEnergy, b.icLatency, b.icDynamicEnergy, 
+					b.coreLatencyADC, b.coreLatencyAccum, b.coreLatencyOther, b.coreEnergyADC, b.coreEnergyAccum, b.coreEnergyOther};
+	return memcmp(x, y, sizeof(x)) == 0;
+}
 
+
+string MonteCarloStatistics(vector<double> value, double scale, const string &unit) {
+	// mean, 5th and 95th percentile of a result over the Monte Carlo trials (param->monteCarloTrials),
+	// summed in trial order and interpolated between the sorted trials, so they do not depend on the thread count
+	double mean = 0;
+	for (int t=0; t<value.size(); t++) {
+		mean += value[t];
+	}
+	mean /= value.size();
+	sort(value.begin(), value.end());
+	double percentile[2] = {0.05, 0.95};
+	for (int k=0; k<2; k++) {
+		double rank = percentile[k] * (value.size()-1);
+		int lower = (int) rank;
+		int upper = MIN(lower+1, (int) value.size()-1);
+		percentile[k] = value[lower] + (rank-lower) * (value[upper]-value[lower]);
+	}
+	ostringstream statistics;
+	statistics << "mean " << mean*scale << unit << ", p5 " << percentile[0]*scale << unit << ", p95 " << percentile[1]*scale << unit;
+	return statistics.str();
+}
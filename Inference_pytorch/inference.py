@@ -33,6 +33,7 @@ parser.add_argument('--onoffratio', default=10)
 parser.add_argument('--cellBit', default=1)
 parser.add_argument('--subArray', default=128)
 parser.add_argument('--ADCprecision', default=5)
+parser.add_argument('--operationmode', default=2, help='NeuroSIM operation mode the traces are recorded for (param->operationmode)')
 parser.add_argument('--vari', default=0)
 parser.add_argument('--t', default=0)
 parser.add_argument('--v', default=0)
@@ -96,7 +97,7 @@ trained_with_quantization = True
 # for data, target in test_loader:
 for i, (data, target) in enumerate(test_loader):
 	if i==0:
-		hook_handle_list = hook.hardware_evaluation(modelCF,args.wl_weight,args.wl_activate)
+		hook_handle_list = hook.hardware_evaluation(modelCF,args.wl_weight,args.wl_activate,args.operationmode)
 	indx_target = target.clone()
 	if args.cuda:
 		data, target = data.cuda(), target.cuda()
@@ -4,45 +4,120 @@ import torch.nn as nn
 import shutil
 from modules.quantization_cpu_np_infer import QConv2d,QLinear
 import numpy as np
+import struct
+import zlib
 import torch
 from utee import wage_quantizer
 
+# 'bin': binary layer traces, memory-mapped by NeuroSIM (see NeuroSIM/TraceFile.h); 'csv': text traces
+TRACE_FORMAT = 'bin'
+TRACE_VERSION = 2
+TRACE_WEIGHT, TRACE_INPUT = 0, 1
+TRACE_BIT, TRACE_INT8, TRACE_INT16, TRACE_SPARSE = 0, 1, 2, 3
+SPARSE_ROW_LIST, SPARSE_RUN_LENGTH, SPARSE_BITMAP = 0, 1, 2
+TRACE_FIXED_POINT = 0
+# NeuroSIM operation mode the traces are recorded for (param->operationmode), set by hardware_evaluation
+operation_mode = 2
+
 def Neural_Sim(self, input, output):
-    input_file_name =  './layer_record/input' + str(self.name) + '.csv'
-    weight_file_name =  './layer_record/weight' + str(self.name) + '.csv'
+    # weights wider than 15 bits are not quantized by wage_quantizer.Q, they stay as text
+    weight_binary = TRACE_FORMAT == 'bin' and int(self.wl_weight) <= 15
+    input_file_name =  './layer_record/input' + str(self.name) + ('.bin' if TRACE_FORMAT == 'bin' else '.csv')
+    weight_file_name =  './layer_record/weight' + str(self.name) + ('.bin' if weight_binary else '.csv')
     f = open('./layer_record/trace_command.sh', "a")
     f.write(weight_file_name+' '+input_file_name+' ')
     weight_q = wage_quantizer.Q(self.weight,self.wl_weight)
-    write_matrix_weight( weight_q.cpu().data.numpy(),weight_file_name)
+    write_matrix_weight( weight_q.cpu().data.numpy(),weight_file_name,int(self.wl_weight))
     if len(self.weight.shape) > 2:
         k=self.weight.shape[-1]
         write_matrix_activation_conv(stretch_input(input[0].cpu().data.numpy(),k),None,self.wl_input,input_file_name)
     else:
         write_matrix_activation_fc(input[0].cpu().data.numpy(),None ,self.wl_input, input_file_name)
 
-def write_matrix_weight(input_matrix,filename):
+def write_matrix_weight(input_matrix,filename,bits=None):
     cout = input_matrix.shape[0]
     weight_matrix = input_matrix.reshape(cout,-1).transpose()
-    np.savetxt(filename, weight_matrix, delimiter=",",fmt='%10.5f')
+    if filename.endswith('.bin'):
+        scale = 1.0 if bits == 1 else 1.0/2**(bits-1)
+        write_trace(filename, TRACE_WEIGHT, weight_matrix, bits, scale)
+    else:
+        np.savetxt(filename, weight_matrix, delimiter=",",fmt='%10.5f')
 
 
 
 
 def write_matrix_activation_conv(input_matrix,fill_dimension,length,filename):
-    filled_matrix_b = np.zeros([input_matrix.shape[2],input_matrix.shape[1]*length],dtype=np.str)
+    filled_matrix_b = np.zeros([input_matrix.shape[2],input_matrix.shape[1]*length],dtype=np.uint8)
     filled_matrix_bin,scale = dec2bin(input_matrix[0,:],length)
     for i,b in enumerate(filled_matrix_bin):
         filled_matrix_b[:,i::length] =  b.transpose()
-    np.savetxt(filename, filled_matrix_b, delimiter=",",fmt='%s')
+    write_matrix_bits(filled_matrix_b,length,filename)
 
 
 def write_matrix_activation_fc(input_matrix,fill_dimension,length,filename):
 
-    filled_matrix_b = np.zeros([input_matrix.shape[1],length],dtype=np.str)
+    filled_matrix_b = np.zeros([input_matrix.shape[1],length],dtype=np.uint8)
     filled_matrix_bin,scale = dec2bin(input_matrix[0,:],length)
     for i,b in enumerate(filled_matrix_bin):
         filled_matrix_b[:,i] =  b
-    np.savetxt(filename, filled_matrix_b, delimiter=",",fmt='%s')
+    write_matrix_bits(filled_matrix_b,length,filename)
+
+def write_matrix_bits(filled_matrix_b,length,filename):
+    if filename.endswith('.bin'):
+        write_trace(filename, TRACE_INPUT, filled_matrix_b, length)
+    else:
+        np.savetxt(filename, filled_matrix_b, delimiter=",",fmt='%d')
+
+def varint(n):
+    n = int(n)
+    out = bytearray()
+    while n >= 0x80:
+        out.append((n & 0x7f) | 0x80)
+        n >>= 7
+    out.append(n)
+    return bytes(out)
+
+def encode_bit_vector(bits):
+    # smallest of a nonzero row list, run lengths or a bitmap, empty if no row is active
+    rows = np.flatnonzero(bits)
+    if len(rows) == 0:
+        return b''
+    gaps = np.diff(rows, prepend=-1) - 1
+    row_list = bytes([SPARSE_ROW_LIST]) + varint(len(rows)) + b''.join(varint(g) for g in gaps)
+    edges = np.flatnonzero(np.diff(np.concatenate(([0], bits, [0]))))
+    starts, ends = edges[0::2], edges[1::2]
+    zero_runs = starts - np.concatenate(([0], ends[:-1]))
+    run_length = bytes([SPARSE_RUN_LENGTH]) + varint(len(starts)) + b''.join(varint(z)+varint(o) for z,o in zip(zero_runs, ends-starts))
+    bitmap = bytes([SPARSE_BITMAP]) + np.packbits(bits, bitorder='little').tobytes()
+    return min((row_list, run_length, bitmap), key=len)
+
+def write_trace(filename,kind,matrix,bits,scale=1.0):
+    # 64-byte little-endian header (NeuroSIM/TraceFile.h), then the payload:
+    # input vectors (columns) sparse encoded one by one after an offset table unless bit-packed rows are smaller,
+    # weights row-major as integer multiples of scale
+    rows, cols = matrix.shape
+    if kind == TRACE_INPUT:
+        records = [encode_bit_vector(matrix[:,c].astype(np.uint8)) for c in range(cols)]
+        offsets = np.concatenate(([0], np.cumsum([len(r) for r in records]))).astype('<u8')
+        dtype, payload = TRACE_SPARSE, offsets.tobytes() + b''.join(records)
+        packed = np.packbits(matrix.astype(np.uint8), axis=1, bitorder='little').tobytes()
+        if len(packed) < len(payload):
+            # dense layers (or few input vectors): plain bit-packed rows
+            dtype, payload = TRACE_BIT, packed
+    else:
+        q = np.round(matrix/scale)
+        if q.min() >= -128 and q.max() <= 127:
+            dtype, payload = TRACE_INT8, q.astype('<i1')
+        elif q.min() >= -32768 and q.max() <= 32767:
+            dtype, payload = TRACE_INT16, q.astype('<i2')
+        else:
+            raise ValueError('weights of ' + filename + ' do not fit in a 16-bit trace')
+        payload = np.ascontiguousarray(payload).tobytes()
+    header = struct.pack('<8sIIIIIIIIdQI4x', b'NSTRACE', TRACE_VERSION, kind, dtype, bits, operation_mode,
+                         rows, cols, zlib.crc32(payload) & 0xffffffff, scale, len(payload), TRACE_FIXED_POINT)
+    with open(filename, 'wb') as f:
+        f.write(header)
+        f.write(payload)
 
 def stretch_input(input_matrix,window_size = 5):
     input_shape = input_matrix.shape
@@ -98,7 +173,9 @@ def remove_hook_list(hook_handle_list):
     for handle in hook_handle_list:
         handle.remove()
 
-def hardware_evaluation(model,wl_weight,wl_activation):
+def hardware_evaluation(model,wl_weight,wl_activation,operationmode=2):
+    global operation_mode
+    operation_mode = int(operationmode)
     hook_handle_list = []
     if not os.path.exists('./layer_record'):
         os.makedirs('./layer_record')